@@ -0,0 +1,183 @@
+/*******************************************************************************************************************
+** Program to benchmark the INA226 library. The time taken by the individual calls is measured with micros() and  **
+** the minimum, mean and maximum times are displayed, followed by the sustained number of register reads and      **
+** samples per second for 1 up to all of the devices found, at each of the 8 conversion time settings. The        **
+** results give a baseline to check changes to the library against, and show what a given setup of devices, bus   **
+** clock and conversion times can achieve.                                                                        **
+**                                                                                                                **
+** Detailed documentation can be found on the GitHub Wiki pages at https://github.com/SV-Zanshin/INA226/wiki      **
+**                                                                                                                **
+** The times include the I2C transfers, so they depend mostly on the bus clock, which can be changed with the     **
+** BUS_CLOCK constant. micros() has a resolution of 4us on 16MHz AVR boards, so short calls are timed over        **
+** REPETITIONS calls and the mean is more accurate than the minimum and maximum. Any number of INA226 devices can **
+** be connected, the shunt settings don't matter since only timings are displayed.                                **
+**                                                                                                                **
+** This program is free software: you can redistribute it and/or modify it under the terms of the GNU General     **
+** Public License as published by the Free Software Foundation, either version 3 of the License, or (at your      **
+** option) any later version. This program is distributed in the hope that it will be useful, but WITHOUT ANY     **
+** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the    **
+** GNU General Public License for more details. You should have received a copy of the GNU General Public License **
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.                                          **
+**                                                                                                                **
+** Vers.  Date       Developer                     Comments                                                       **
+** ====== ========== ============================= ============================================================== **
+** 1.0.0  2026-10-14 https://github.com/SV-Zanshin Created example                                                **
+**                                                                                                                **
+*******************************************************************************************************************/
+#include <INA226.h>                                                           // INA226 Library                   //
+/*******************************************************************************************************************
+** Declare program Constants                                                                                      **
+*******************************************************************************************************************/
+const uint32_t SERIAL_SPEED       = 115200;                                   // Use fast serial speed            //
+const uint32_t BUS_CLOCK          = INA_I2C_FAST_MODE;                        // I2C clock for all measurements   //
+const uint16_t REPETITIONS        =    100;                                   // Calls timed for each method      //
+const uint16_t RATE_MILLIS        =   1000;                                   // Time to measure each rate for    //
+/*******************************************************************************************************************
+** Declare global variables and instantiate classes                                                               **
+*******************************************************************************************************************/
+INA226_Class   INA226;                                                        // INA class instantiation          //
+uint8_t        devicesFound = 0;                                              // Number of INA226s found          //
+INA226_Sample  samples[INA_MAX_DEVICES];                                      // Samples read by readRawAll()     //
+INA226_Reading reading;                                                       // Reading for readAll()            //
+typedef void (*benchFunction)();                                              // Call to be timed                 //
+/*******************************************************************************************************************
+** The calls to be timed. Each is a function without parameters so that they can all be timed by timeCalls().     **
+*******************************************************************************************************************/
+void benchBusRaw()          { INA226.getBusRaw(); }                           // readWord() of one register       //
+void benchBusMilliVolts()   { INA226.getBusMilliVolts(); }                    //                                  //
+void benchShuntMicroVolts() { INA226.getShuntMicroVolts(); }                  //                                  //
+void benchBusMicroAmps()    { INA226.getBusMicroAmps(); }                     //                                  //
+void benchBusMicroWatts()   { INA226.getBusMicroWatts(); }                    //                                  //
+void benchReadAll()         { INA226.readAll(0,reading); }                    // All 4 registers of device 0      //
+void benchReadRawAll()      { INA226.readRawAll(samples); }                   // All devices with new data        //
+void benchSetAveraging()    { INA226.setAveraging(1); }                       // Setters of all devices           //
+void benchSetBusConversion(){ INA226.setBusConversion(0); }                   //                                  //
+void benchSetMode()         { INA226.setMode(INA_MODE_CONTINUOUS_BOTH); }     //                                  //
+void benchWaitConversion()  { INA226.waitForConversion(0); }                  // Wait for device 0                //
+/*******************************************************************************************************************
+** Function printTime displays a time or rate with a fixed width, so that the columns line up.                    **
+*******************************************************************************************************************/
+void printTime(const uint32_t value,const uint8_t width=7) {                  // Display a value right aligned    //
+  uint8_t digits = 1;                                                         // Number of digits in the value    //
+  for(uint32_t i=value;i>9;i/=10) digits++;                                   //                                  //
+  for(uint8_t i=digits;i<width;i++) Serial.print(' ');                        // Pad to the width                 //
+  Serial.print(value);                                                        //                                  //
+} // of function printTime()                                                  //                                  //
+/*******************************************************************************************************************
+** Function timeCalls calls the function count times, each call being timed separately, and displays the minimum, **
+** mean and maximum time taken in microseconds and the number of calls per second.                                **
+*******************************************************************************************************************/
+void timeCalls(const __FlashStringHelper *name,benchFunction function,        // Time and display one call        //
+               const uint16_t count=REPETITIONS) {                            //                                  //
+  uint32_t minimum = UINT32_MAX;                                              // Shortest call                    //
+  uint32_t maximum = 0;                                                       // Longest call                     //
+  uint32_t total   = 0;                                                       // Time taken by all calls          //
+  for(uint16_t i=0;i<count;i++) {                                             // Call count times                 //
+    uint32_t startMicros = micros();                                          //                                  //
+    function();                                                               //                                  //
+    uint32_t callMicros  = micros()-startMicros;                              // Time taken by the call           //
+    if (callMicros<minimum) minimum = callMicros;                             //                                  //
+    if (callMicros>maximum) maximum = callMicros;                             //                                  //
+    total += callMicros;                                                      //                                  //
+  } // for-next each call                                                     //                                  //
+  Serial.print(name);                                                         // Display the results              //
+  printTime(minimum);                                                         //                                  //
+  printTime((total+count/2)/count);                                           //                                  //
+  printTime(maximum);                                                         //                                  //
+  printTime(total ? (uint64_t)count*1000000/total : 0,8);                     // Calls per second                 //
+  Serial.print('\n');                                                         //                                  //
+} // of function timeCalls()                                                  //                                  //
+/*******************************************************************************************************************
+** Function setConversion sets all devices to the conversion time index for both the bus and shunt, without       **
+** averaging, and continuous mode.                                                                                **
+*******************************************************************************************************************/
+void setConversion(const uint8_t conversion) {                                // Set conversion time of devices   //
+  INA226.setAveraging(1);                                                     // No averaging                     //
+  INA226.setBusConversion(conversion);                                        //                                  //
+  INA226.setShuntConversion(conversion);                                      //                                  //
+  INA226.setMode(INA_MODE_CONTINUOUS_BOTH);                                   //                                  //
+} // of function setConversion()                                              //                                  //
+/*******************************************************************************************************************
+** Function measureRate calls readRawAll() for the first devices of the table for RATE_MILLIS milliseconds and    **
+** displays the number of calls per second, which is limited by the bus, and the number of new samples per        **
+** second, which is limited by the conversion time.                                                               **
+*******************************************************************************************************************/
+void measureRate(const uint8_t devices) {                                     // Display sustained rates          //
+  uint16_t deviceMask  = ((uint32_t)1<<devices)-1;                            // Select the first devices         //
+  uint32_t calls       = 0;                                                   // Calls of readRawAll()            //
+  uint32_t samplesRead = 0;                                                   // New samples read                 //
+  uint32_t startMillis = millis();                                            //                                  //
+  while (millis()-startMillis<RATE_MILLIS) {                                  // Read for RATE_MILLIS             //
+    samplesRead += INA226.readRawAll(samples,deviceMask);                     //                                  //
+    calls++;                                                                  //                                  //
+  } // of while measuring                                                     //                                  //
+  printTime(devices,4);                                                       // Display per second values        //
+  printTime(calls*1000/RATE_MILLIS,10);                                       //                                  //
+  printTime(samplesRead*1000/RATE_MILLIS,10);                                 //                                  //
+  printTime(samplesRead*1000/RATE_MILLIS/devices,11);                         //                                  //
+  Serial.print('\n');                                                         //                                  //
+} // of function measureRate()                                                //                                  //
+/*******************************************************************************************************************
+** Method Setup(). This is an Arduino IDE method which is called first upon initial boot or restart. It is only   **
+** called one time and here the whole benchmark is run, since it only needs to be done once.                      **
+*******************************************************************************************************************/
+void setup() {                                                                //                                  //
+  Serial.begin(SERIAL_SPEED);                                                 // Start serial communications      //
+  #ifdef  __AVR_ATmega32U4__                                                  // If this is a 32U4 processor,     //
+    delay(3000);                                                              // wait 3 seconds for serial port   //
+  #endif                                                                      // interface to initialize          //
+  Serial.print(F("\n\nINA226 Benchmark V1.0.0\n"));                           // Display program information      //
+  INA226.setBusClock(BUS_CLOCK);                                              // Set by begin() after Wire.begin()//
+  uint32_t startMicros = micros();                                            // Time the enumeration of devices  //
+  devicesFound = INA226.begin(1,100000);                                      //                                  //
+  uint32_t beginMicros = micros()-startMicros;                                //                                  //
+  if (devicesFound==0) {                                                      // Nothing to measure without a     //
+    Serial.print(F("No Device detected.\n"));                                 // device                           //
+    return;                                                                   //                                  //
+  } // of if-then no device found                                             //                                  //
+  Serial.print(F("Devices found:              "));                            //                                  //
+  Serial.print(devicesFound);                                                 //                                  //
+  Serial.print(F("\nBus clock Hz:               "));                          //                                  //
+  Serial.print(BUS_CLOCK);                                                    //                                  //
+  Serial.print(F("\nbegin() enumeration in us:  "));                          //                                  //
+  Serial.print(beginMicros);                                                  //                                  //
+  Serial.print(F("\n\nCall times in us        min   mean    max calls/s\n")); //                                  //
+  setConversion(0);                                                           // Fastest conversions              //
+  timeCalls(F("getBusRaw()         "),benchBusRaw);                           //                                  //
+  timeCalls(F("getBusMilliVolts()  "),benchBusMilliVolts);                    //                                  //
+  timeCalls(F("getShuntMicroVolts()"),benchShuntMicroVolts);                  //                                  //
+  timeCalls(F("getBusMicroAmps()   "),benchBusMicroAmps);                     //                                  //
+  timeCalls(F("getBusMicroWatts()  "),benchBusMicroWatts);                    //                                  //
+  timeCalls(F("readAll()           "),benchReadAll);                          //                                  //
+  timeCalls(F("readRawAll()        "),benchReadRawAll);                       //                                  //
+  timeCalls(F("setAveraging()      "),benchSetAveraging);                     //                                  //
+  timeCalls(F("setBusConversion()  "),benchSetBusConversion);                 //                                  //
+  timeCalls(F("setMode() all       "),benchSetMode);                          //                                  //
+  Serial.print(F("\nwaitForConversion() us  min   mean    max"));             //                                  //
+  Serial.print(F(" calls/s\n"));                                              //                                  //
+  for(uint8_t conversion=0;conversion<8;conversion++) {                       // Each conversion time, which sets //
+    setConversion(conversion);                                                // the time between conversions     //
+    Serial.print(F("conversion time "));                                      //                                  //
+    Serial.print(conversion);                                                 //                                  //
+    Serial.print(F("   "));                                                   //                                  //
+    timeCalls(F(""),benchWaitConversion,conversion<5 ? 20 : 4);               // Fewer repetitions when slow      //
+  } // for-next each conversion time                                          //                                  //
+  for(uint8_t conversion=0;conversion<8;conversion++) {                       // Each conversion time             //
+    setConversion(conversion);                                                //                                  //
+    Serial.print(F("\nConversion time "));                                    //                                  //
+    Serial.print(conversion);                                                 //                                  //
+    Serial.print(F(", period "));                                             //                                  //
+    Serial.print(INA226.getConversionPeriod());                               //                                  //
+    Serial.print(F("us\nDevs   reads/s samples/s per device\n"));             //                                  //
+    for(uint8_t devices=1;devices<=devicesFound;devices++) {                  // Rates for 1 to all devices       //
+      measureRate(devices);                                                   //                                  //
+    } // for-next each number of devices                                      //                                  //
+  } // for-next each conversion time                                          //                                  //
+  Serial.print(F("\nBenchmark done.\n"));                                     //                                  //
+} // of method setup()                                                        //                                  //
+/*******************************************************************************************************************
+** This is the main program for the Arduino IDE, it is called in an infinite loop. The benchmark is run in        **
+** setup() so nothing is done here.                                                                               **
+*******************************************************************************************************************/
+void loop() {                                                                 // Main program loop                //
+} // of method loop                                                           //----------------------------------//
@@ -0,0 +1,68 @@
+/*******************************************************************************************************************
+** Program to demonstrate the binary frame format of the INA226 library. Samples are read by the interrupt-driven **
+** sampling engine into a ring buffer as in the SampleBuffer example, but instead of being converted and printed  **
+** as text they are written to the serial port as compact binary frames with INA226_FrameEncoder. With delta      **
+** encoding on a frame takes 10 to 18 bytes instead of the 40 or more that the text of the same values needs, so  **
+** the same serial link carries three to four times as many samples.                                              **
+**                                                                                                                **
+** Detailed documentation can be found on the GitHub Wiki pages at https://github.com/SV-Zanshin/INA226/wiki      **
+**                                                                                                                **
+** On the receiving end the frames are turned back into samples with INA226_FrameDecoder, by passing it each byte **
+** received, and the samples can then be converted to units with convertSample() using the same calibration. The  **
+** frame layout is described in INA226.h for decoders written in other languages.                                 **
+**                                                                                                                **
+** This example is for INA226 devices set up to measure a 5-Volt load with a 0.1 Ohm resistor in place. They are  **
+** set up to use the shortest conversion time without averaging, which gives a new sample from each device every  **
+** 280us. The ALERT pins are connected together to pin 2, which can be used for an external interrupt on most     **
+** Arduino boards.                                                                                                **
+**                                                                                                                **
+** This program is free software: you can redistribute it and/or modify it under the terms of the GNU General     **
+** Public License as published by the Free Software Foundation, either version 3 of the License, or (at your      **
+** option) any later version. This program is distributed in the hope that it will be useful, but WITHOUT ANY     **
+** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the    **
+** GNU General Public License for more details. You should have received a copy of the GNU General Public License **
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.                                          **
+**                                                                                                                **
+** Vers.  Date       Developer                     Comments                                                       **
+** ====== ========== ============================= ============================================================== **
+** 1.0.0  2026-10-14 https://github.com/SV-Zanshin Created example                                                **
+**                                                                                                                **
+*******************************************************************************************************************/
+#include <INA226.h>                                                           // INA226 Library                   //
+/*******************************************************************************************************************
+** Declare program Constants                                                                                      **
+*******************************************************************************************************************/
+const uint8_t  INA226_ALERT_PIN   =      2;                                   // Pin 2, external interrupt capable//
+const uint32_t SERIAL_SPEED       = 500000;                                   // Binary data needs a fast link    //
+/*******************************************************************************************************************
+** Declare global variables and instantiate classes                                                               **
+*******************************************************************************************************************/
+INA226_Class                 INA226;                                          // INA class instantiation          //
+INA226_RingBuffer<64>        samples;                                         // Buffer for up to 64 samples      //
+INA226_FrameEncoder          encoder(Serial,true);                            // Delta encoded frames to Serial   //
+/*******************************************************************************************************************
+** Method Setup(). This is an Arduino IDE method which is called first upon initial boot or restart. It is only   **
+** called one time and all of the variables and other initialization calls are done here prior to entering the    **
+** main loop for data measurement.                                                                                **
+*******************************************************************************************************************/
+void setup() {                                                                //                                  //
+  Serial.begin(SERIAL_SPEED);                                                 // Start serial communications      //
+  #ifdef  __AVR_ATmega32U4__                                                  // If this is a 32U4 processor,     //
+    delay(3000);                                                              // wait 3 seconds for serial port   //
+  #endif                                                                      // interface to initialize          //
+  // The begin initialized the calibration for an expected 1 Amps maximum current and for a 0.1 Ohm resistor     //
+  while (INA226.begin(1,100000)==0) delay(1000);                              // Wait for a device, no text output//
+  INA226.setAveraging(1);                                                     // No averaging                     //
+  INA226.setBusConversion(0);                                                 // Shortest conversion time 140us   //
+  INA226.setShuntConversion(0);                                               // Shortest conversion time 140us   //
+  INA226.setMode(INA_MODE_CONTINUOUS_BOTH);                                   // Bus/shunt measured continuously  //
+  INA226.startSampling(samples,INA226_ALERT_PIN);                             // Start sampling all devices       //
+} // of method setup()                                                        //                                  //
+/*******************************************************************************************************************
+** This is the main program for the Arduino IDE, it is called in an infinite loop. The service() call reads any   **
+** finished conversions into the sample buffer and the encoder then writes all buffered samples as frames.        **
+*******************************************************************************************************************/
+void loop() {                                                                 // Main program loop                //
+  INA226.service();                                                           // Read finished conversions        //
+  encoder.write(samples);                                                     // Send all buffered samples        //
+} // of method loop                                                           //----------------------------------//
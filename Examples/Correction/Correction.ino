@@ -0,0 +1,95 @@
+/*******************************************************************************************************************
+** Program to demonstrate the shunt error correction of the INA226 library. The resistance of a shunt is only     **
+** known to its tolerance, typically 1%, and the INA226 adds a small offset of its own. With calibrateCurrent()   **
+** both are measured, first with no load connected for the offset and then with a known reference load for the    **
+** gain, and the correction is stored in EEPROM with saveConfig() so it only has to be done once. All readings    **
+** are corrected, and so are alert limits set afterwards, which is shown here with an over-current alert whose    **
+** flag is printed next to the corrected current.                                                                 **
+**                                                                                                                **
+** Detailed documentation can be found on the GitHub Wiki pages at https://github.com/SV-Zanshin/INA226/wiki      **
+**                                                                                                                **
+** This example is for an INA226 set up to measure a 5-Volt load with a 0.1 Ohm resistor in place. For the        **
+** calibration the load is first disconnected and then replaced by one drawing the REFERENCE_MICRO_AMPS, measured **
+** with a good multimeter or set with a calibrated electronic load. Sending any character over the serial port    **
+** moves to the next step.                                                                                        **
+**                                                                                                                **
+** This program is free software: you can redistribute it and/or modify it under the terms of the GNU General     **
+** Public License as published by the Free Software Foundation, either version 3 of the License, or (at your      **
+** option) any later version. This program is distributed in the hope that it will be useful, but WITHOUT ANY     **
+** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the    **
+** GNU General Public License for more details. You should have received a copy of the GNU General Public License **
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.                                          **
+**                                                                                                                **
+** Vers.  Date       Developer                     Comments                                                       **
+** ====== ========== ============================= ============================================================== **
+** 1.0.0  2026-10-14 https://github.com/SV-Zanshin Created example                                                **
+**                                                                                                                **
+*******************************************************************************************************************/
+#include <INA226.h>                                                           // INA226 Library                   //
+/*******************************************************************************************************************
+** Declare program Constants                                                                                      **
+*******************************************************************************************************************/
+const int32_t  REFERENCE_MICRO_AMPS = 250000;                                 // Calibration load of 250mA        //
+const int32_t  ALERT_MICRO_AMPS     = 200000;                                 // Over-current alert at 200mA      //
+const uint32_t SERIAL_SPEED         = 115200;                                 // Use fast serial speed            //
+/*******************************************************************************************************************
+** Declare global variables and instantiate classes                                                               **
+*******************************************************************************************************************/
+INA226_Class INA226;                                                          // INA class instantiation          //
+/*******************************************************************************************************************
+** Method waitForKey() prints the prompt and then waits until a character has been received over the serial port, **
+** discarding everything that was received.                                                                       **
+*******************************************************************************************************************/
+void waitForKey(const __FlashStringHelper *prompt) {                          // Print prompt and wait for a key  //
+  Serial.println(prompt);                                                     //                                  //
+  while (!Serial.available()) delay(10);                                      //                                  //
+  delay(100);                                                                 // Let the rest of the line arrive  //
+  while (Serial.available()) Serial.read();                                   // and discard it                   //
+} // of method waitForKey()                                                   //                                  //
+/*******************************************************************************************************************
+** Method Setup(). This is an Arduino IDE method which is called first upon initial boot or restart. It is only   **
+** called one time and all of the variables and other initialization calls are done here prior to entering the    **
+** main loop for data measurement.                                                                                **
+*******************************************************************************************************************/
+void setup() {                                                                //                                  //
+  Serial.begin(SERIAL_SPEED);                                                 // Start serial communications      //
+  #ifdef  __AVR_ATmega32U4__                                                  // If this is a 32U4 processor,     //
+    delay(3000);                                                              // wait 3 seconds for serial port   //
+  #endif                                                                      // interface to initialize          //
+  Serial.print(F("\n\nShunt error correction\n"));                            //                                  //
+  // The begin initialized the calibration for an expected 1 Amps maximum current and for a 0.1 Ohm resistor     //
+  while (INA226.begin(1,100000)==0) {                                         // Keep trying until found          //
+    Serial.println(F("No INA found, waiting 5 seconds and trying again...")); //                                  //
+    delay(5000);                                                              //                                  //
+  } // of while no device found                                               //                                  //
+  INA226.setAveraging(64);                                                    // Average each reading 64 times    //
+  INA226.setMode(INA_MODE_CONTINUOUS_BOTH);                                   // Bus/shunt measured continuously  //
+  waitForKey(F("Disconnect the load and press enter"));                       //                                  //
+  INA226.calibrateCurrent(0);                                                 // Measure the offset               //
+  waitForKey(F("Connect the reference load and press enter"));                //                                  //
+  if (INA226.calibrateCurrent(REFERENCE_MICRO_AMPS)) {                        // Measure the gain and store the   //
+    INA226.saveConfig();                                                      // correction for the next start    //
+  } else {                                                                    //                                  //
+    Serial.println(F("Reading too far from the reference, not corrected"));   //                                  //
+  } // of if-then-else gain measured                                          //                                  //
+  uint16_t gain;                                                              //                                  //
+  int16_t  offset;                                                            //                                  //
+  INA226.getCorrection(0,gain,offset);                                        // Show the correction in use       //
+  Serial.print(F("Gain "));                                                   //                                  //
+  Serial.print((float)gain/INA_GAIN_UNITY,5);                                 //                                  //
+  Serial.print(F(", offset "));                                               //                                  //
+  Serial.println(offset);                                                     //                                  //
+  INA226.setAlertLimit(INA_ALERT_CURRENT_OVER_UA,ALERT_MICRO_AMPS);           // Set after the correction, so it  //
+} // of method setup()                                                        // uses the corrected scale         //
+/*******************************************************************************************************************
+** This is the main program for the Arduino IDE, it is called in an infinite loop. The corrected current is       **
+** printed once a second with the over-current alert flag, which is set once the current printed is above         **
+** ALERT_MICRO_AMPS.                                                                                              **
+*******************************************************************************************************************/
+void loop() {                                                                 // Main program loop                //
+  int32_t microAmps = INA226.getBusMicroAmps();                               // Corrected current                //
+  Serial.print(microAmps/1000.0,3);                                           //                                  //
+  Serial.print(F("mA"));                                                      //                                  //
+  Serial.println(INA226.getAlertFlag() ? F(" over the limit") : F(""));       //                                  //
+  delay(1000);                                                                //                                  //
+} // of method loop                                                           //----------------------------------//
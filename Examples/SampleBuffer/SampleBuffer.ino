@@ -0,0 +1,100 @@
+/*******************************************************************************************************************
+** Program to demonstrate the interrupt-driven sampling engine of the INA226 library. The ALERT pin of the INA226 **
+** is connected to an interrupt-capable pin of the Arduino, and the library's interrupt handler only sets a flag  **
+** when a conversion has finished. The main loop calls service() to read the measurements into a ring buffer and  **
+** takes the samples out again when it is ready to process them, no interrupts need to be disabled for this.      **
+**                                                                                                                **
+** Detailed documentation can be found on the GitHub Wiki pages at https://github.com/SV-Zanshin/INA226/wiki      **
+**                                                                                                                **
+** This example is for a INA226 set up to measure a 5-Volt load with a 0.1 Ohm resistor in place. The INA226 is   **
+** set up to measure using the maximum conversion length and to average the readings 16 times, resulting in a new **
+** sample every 264ms. Every 5 seconds the samples collected so far are averaged and displayed along with the     **
+** number of samples that had to be dropped because the buffer was full.                                          **
+**                                                                                                                **
+** The interrupt is set to pin 2, which can be used for an external interrupt on most Arduino boards.             **
+**                                                                                                                **
+** This program is free software: you can redistribute it and/or modify it under the terms of the GNU General     **
+** Public License as published by the Free Software Foundation, either version 3 of the License, or (at your      **
+** option) any later version. This program is distributed in the hope that it will be useful, but WITHOUT ANY     **
+** WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the    **
+** GNU General Public License for more details. You should have received a copy of the GNU General Public License **
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.                                          **
+**                                                                                                                **
+** Vers.  Date       Developer                     Comments                                                       **
+** ====== ========== ============================= ============================================================== **
+** 1.0.0  2026-10-14 https://github.com/SV-Zanshin Created example                                                **
+**                                                                                                                **
+*******************************************************************************************************************/
+#include <INA226.h>                                                           // INA226 Library                   //
+/*******************************************************************************************************************
+** Declare program Constants                                                                                      **
+*******************************************************************************************************************/
+const uint8_t  INA226_ALERT_PIN   =      2;                                   // Pin 2, external interrupt capable//
+const uint32_t SERIAL_SPEED       = 115200;                                   // Use fast serial speed            //
+const uint32_t DISPLAY_INTERVAL   =   5000;                                   // Milliseconds between displays    //
+/*******************************************************************************************************************
+** Declare global variables and instantiate classes                                                               **
+*******************************************************************************************************************/
+INA226_Class                 INA226;                                          // INA class instantiation          //
+INA226_RingBuffer<32>        samples;                                         // Buffer for up to 32 samples      //
+/*******************************************************************************************************************
+** Method Setup(). This is an Arduino IDE method which is called first upon initial boot or restart. It is only   **
+** called one time and all of the variables and other initialization calls are done here prior to entering the    **
+** main loop for data measurement.                                                                                **
+*******************************************************************************************************************/
+void setup() {                                                                //                                  //
+  Serial.begin(SERIAL_SPEED);                                                 // Start serial communications      //
+  #ifdef  __AVR_ATmega32U4__                                                  // If this is a 32U4 processor,     //
+    delay(3000);                                                              // wait 3 seconds for serial port   //
+  #endif                                                                      // interface to initialize          //
+  Serial.print(F("\n\nINA226 Sample Buffer V1.0.0\n"));                       // Display program information      //
+  // The begin initialized the calibration for an expected 1 Amps maximum current and for a 0.1 Ohm resistor     //
+  while (INA226.begin(1,100000)==0) {                                         //                                  //
+    Serial.print(F("No Device detected. Sleeping 10 seconds.\n"));            //                                  //
+    delay(10000);                                                             //                                  //
+  } // of if-then no device found                                             //                                  //
+  INA226.setAveraging(16);                                                    // Average each reading n-times     //
+  INA226.setBusConversion(7);                                                 // Maximum conversion time 8.244ms  //
+  INA226.setShuntConversion(7);                                               // Maximum conversion time 8.244ms  //
+  INA226.setMode(INA_MODE_CONTINUOUS_BOTH);                                   // Bus/shunt measured continuously  //
+  if (!INA226.startSampling(samples,INA226_ALERT_PIN)) {                      // Start sampling all devices       //
+    Serial.print(F("Pin cannot be used for an interrupt.\n"));                //                                  //
+  } // of if-then sampling could not be started                               //                                  //
+} // of method setup()                                                        //                                  //
+/*******************************************************************************************************************
+** This is the main program for the Arduino IDE, it is called in an infinite loop. The service() call reads any   **
+** finished conversions into the sample buffer, and every DISPLAY_INTERVAL milliseconds the buffered samples are  **
+** averaged and displayed.                                                                                        **
+*******************************************************************************************************************/
+void loop() {                                                                 // Main program loop                //
+  static uint32_t lastMillis = millis();                                      // Store the last time we printed   //
+  static uint32_t lastDropped = 0;                                            // Dropped count at last display    //
+  INA226.service();                                                           // Read finished conversions        //
+  if (millis()-lastMillis>=DISPLAY_INTERVAL) {                                // If it is time to display results //
+    INA226_Sample  sample;                                                    // Raw sample from the buffer       //
+    INA226_Reading reading;                                                   // Converted sample values          //
+    int64_t  sumBusMicroAmps = 0;                                             // Sum of bus amperage readings     //
+    uint32_t sumBusMillVolts = 0;                                             // Sum of bus voltage readings      //
+    uint8_t  readings        = 0;                                             // Number of samples taken out      //
+    while (samples.pop(sample)) {                                             // Take out each buffered sample    //
+      INA226.convertSample(sample,reading);                                   // and convert it to units          //
+      sumBusMillVolts += reading.busMilliVolts;                               //                                  //
+      sumBusMicroAmps += reading.busMicroAmps;                                //                                  //
+      readings++;                                                             //                                  //
+    } // of while samples in buffer                                           //                                  //
+    if (readings) {                                                           // Only display if there's data     //
+      Serial.print(F("Averaging "));                                          //                                  //
+      Serial.print(readings);                                                 //                                  //
+      Serial.print(F(" samples.\nBus voltage:   "));                          //                                  //
+      Serial.print((float)sumBusMillVolts/readings/1000.0,4);                 //                                  //
+      Serial.print(F("V\nBus amperage:  "));                                  //                                  //
+      Serial.print((float)sumBusMicroAmps/readings/1000.0,4);                 //                                  //
+      Serial.print(F("mA\n"));                                                //                                  //
+    } // of if-then samples were read                                         //                                  //
+    Serial.print(F("Dropped samples: "));                                     //                                  //
+    Serial.print(samples.dropped()-lastDropped);                              //                                  //
+    Serial.print(F("\n\n"));                                                  //                                  //
+    lastDropped = samples.dropped();                                          //                                  //
+    lastMillis  = millis();                                                   //                                  //
+  } // of if-then time to display results                                     //                                  //
+} // of method loop                                                           //----------------------------------//
@@ -15,120 +15,662 @@
 #include "INA226.h"                                                           // Include the header definition    //
 #include <Wire.h>                                                             // I2C Library definition           //
 #include <EEPROM.h>                                                           // Include the EEPROM library       //
+#if defined(__AVR__)                                                          // Sleep modes for sampleLowPower() //
+  #include <avr/sleep.h>                                                      //                                  //
+#endif                                                                        //                                  //
+#if INA_LOG_LEVEL>INA_LOG_NONE                                                // Only if logging is compiled in   //
+const char INA_EVENT_NAMES[] PROGMEM =                                        // Names of the log events, in the  //
+  "device\0reset\0calibration\0currentLSB\0powerLSB\0loaded\0i2cError\0"      // order of the INA_EVENT constants //
+  "timeout\0bufferFull\0configuration";                                       //                                  //
+#endif                                                                        //                                  //
+const uint16_t INA_CONVERSION_MICROS[8] PROGMEM =                             // Conversion times in microseconds //
+  {140,204,332,588,1100,2116,4156,8244};                                      // for each conversion time index   //
+INA226_Class *INA226_Class::_SamplingInstance = NULL;                         // Instance using attached ISR      //
+INA226_Multi *INA226_Multi::_AsyncInstance = NULL;                            // Instance with reads running      //
 INA226_Class::INA226_Class()  {}                                              // Class constructor                //
 INA226_Class::~INA226_Class() {}                                              // Unused class destructor          //
 /*******************************************************************************************************************
 ** Method begin() sets the INA226 Configuration details, without which meaningful readings cannot be made. If it  **
 ** is called without the option deviceNumber parameter then the settings are applied to all devices, otherwise    **
-** just that specific device is targeted.                                                                         **
+** just that specific device is targeted. On the first call all 16 possible addresses are scanned for devices,    **
+** which are then reset.                                                                                          **
 *******************************************************************************************************************/
 uint8_t INA226_Class::begin(const uint8_t maxBusAmps,                         // Class initializer                //
                             const uint32_t microOhmR,                         //                                  //
                             const uint8_t deviceNumber ) {                    //                                  //
-  inaDet ina;                                                                 // Hold device details in structure //
-  uint16_t manufacturerId;                                                    // Read manufacturerId from device  //
   if (_DeviceCount==0) {                                                      // Enumerate devices in first call  //
-    Wire.begin();                                                             // Start the I2C wire subsystem     //
-    for(uint8_t deviceAddress = 64;deviceAddress<79;deviceAddress++) {        // Loop for each possible address   //
-      Wire.beginTransmission(deviceAddress);                                  // See if something is at address   //
-      if (Wire.endTransmission() == 0) {                                      // by checking the return error     //
-        if (readWord(INA_MANUFACTURER_ID_REGISTER,deviceAddress)==0x5449) {   // Check hard-coded manufacturerId  //
-          writeWord(INA_CONFIGURATION_REGISTER,INA_RESET_DEVICE,deviceAddress);// Force INAs to reset             //
-          delay(I2C_DELAY);                                                   // Wait for INA to finish resetting //
-          if (readWord(INA_CONFIGURATION_REGISTER,deviceAddress)              // Yes, we've found an INA226!      //
-              ==INA_DEFAULT_CONFIGURATION) {                                  //                                  //
-            ina.address       = deviceAddress;                                // Store device address             //
-            ina.operatingMode = B111;                                         // Default to continuous mode       //
-            if ((_DeviceCount*sizeof(ina))<EEPROM.length()) {                 // If there's space left in EEPROM  //
-              EEPROM.put(_DeviceCount*sizeof(ina),ina);                       // Add the structure                //
-              _DeviceCount++;                                                 // Increment the device counter     //
-            } // of if-then the values will fit into EEPROM                   //                                  //
-          } // of if-then we have identified a INA226                         //                                  //
-        } // of if-then we have identified a INA226 manufacturer code         //                                  //
-      } // of if-then we have found a live device                             //                                  //
+    startBus();                                                               // Start the I2C bus                //
+    for(uint8_t deviceAddress = 64;deviceAddress<80;deviceAddress++) {        // Loop for each possible address   //
+      probeDevice(deviceAddress,true);                                        // Add any INA226 found to table    //
     } // for-next each possible I2C address                                   //                                  //
   } // of if-then first call with no devices found                            //                                  //
-  EEPROM.get((deviceNumber%_DeviceCount)*sizeof(ina),ina);                    // Read EEPROM values for device    //
-  ina.current_LSB = (uint64_t)maxBusAmps*1000000000/32767;                    // Get the best possible LSB in nA  //
-  ina.calibration = (uint64_t)51200000 / ((uint64_t)ina.current_LSB *         // Compute calibration register     //
-                    (uint64_t)microOhmR / (uint64_t)100000);                  // using 64 bit numbers throughout  //
-  ina.power_LSB   = (uint32_t)25*ina.current_LSB;                             // Fixed multiplier for INA219      //
-  #ifdef debug_Mode                                                           // Display values when debugging    //
-  Serial.print(F("current_LSB = ")); Serial.println(ina.current_LSB);         //                                  //
-  Serial.print(F("calibration = ")); Serial.println(ina.calibration);         //                                  //
-  Serial.print(F("power_LSB   = ")); Serial.println(ina.power_LSB);           //                                  //
-  #endif                                                                      // end of conditional compile code  //
-  if (deviceNumber==UINT8_MAX) {                                              // If default value, then set all   //
-    for(uint8_t i=0;i<_DeviceCount;i++) {                                     // For each device write data       //
-      EEPROM.put(i*sizeof(ina),ina);                                          // Write value to address           //
-      writeWord(INA_CALIBRATION_REGISTER,ina.calibration,ina.address);        // Write the calibration value      //
-    } // of for each device                                                   //                                  //
-  } else {                                                                    //                                  //
-    EEPROM.put((deviceNumber%_DeviceCount)*sizeof(ina),ina);                  // Write struct, cater for overflow //
-    writeWord(INA_CALIBRATION_REGISTER,ina.calibration,ina.address);          // Write the calibration value      //
-  } // of if-then-else set one or all devices                                 //                                  //
+  return calibrate(maxBusAmps,microOhmR,deviceNumber);                        // Compute and write calibration    //
+} // of method begin()                                                        //                                  //
+/*******************************************************************************************************************
+** Overloaded method begin() is a faster alternative for a cold start when the device addresses are already       **
+** known. On the first call only the addressCount addresses in the addresses array are probed, in that order, so  **
+** the device numbers follow the order of the list. If resetDevices is false then the devices are not reset and   **
+** instead their configuration is read back, checked and used as the starting point of the cached registers. If   **
+** none of the listed devices respond then the full scan of all addresses is done as a fallback.                  **
+*******************************************************************************************************************/
+uint8_t INA226_Class::begin(const uint8_t maxBusAmps,                         // Class initializer                //
+                            const uint32_t microOhmR,                         // using a list of addresses        //
+                            const uint8_t addresses[],                        //                                  //
+                            const uint8_t addressCount,                       //                                  //
+                            const bool resetDevices,                          //                                  //
+                            const uint8_t deviceNumber) {                     //                                  //
+  if (_DeviceCount==0) {                                                      // Enumerate devices in first call  //
+    startBus();                                                               // Start the I2C bus                //
+    for(uint8_t i=0;i<addressCount;i++) {                                     // Loop for each listed address     //
+      probeDevice(addresses[i],resetDevices);                                 // and add any INA226 found         //
+    } // for-next each listed I2C address                                     //                                  //
+  } // of if-then first call with no devices found                            //                                  //
+  if (_DeviceCount==0) return begin(maxBusAmps,microOhmR,deviceNumber);       // Fall back to the full scan       //
+  return calibrate(maxBusAmps,microOhmR,deviceNumber);                        // Compute and write calibration    //
+} // of method begin()                                                        //                                  //
+/*******************************************************************************************************************
+** Overloaded method begin() works like the address list version, but the addresses to probe are given as a       **
+** bitmask where bit 0 is address 0x40 (64) and bit 15 is address 0x4F (79).                                      **
+*******************************************************************************************************************/
+uint8_t INA226_Class::begin(const uint8_t maxBusAmps,                         // Class initializer                //
+                            const uint32_t microOhmR,                         // using a bitmask of addresses     //
+                            const uint16_t addressMask,                       //                                  //
+                            const bool resetDevices,                          //                                  //
+                            const uint8_t deviceNumber) {                     //                                  //
+  if (_DeviceCount==0) {                                                      // Enumerate devices in first call  //
+    startBus();                                                               // Start the I2C bus                //
+    for(uint8_t i=0;i<16;i++) {                                               // Loop for each possible address   //
+      if (bitRead(addressMask,i)) probeDevice(64+i,resetDevices);             // and check the ones selected      //
+    } // for-next each possible I2C address                                   //                                  //
+  } // of if-then first call with no devices found                            //                                  //
+  if (_DeviceCount==0) return begin(maxBusAmps,microOhmR,deviceNumber);       // Fall back to the full scan       //
+  return calibrate(maxBusAmps,microOhmR,deviceNumber);                        // Compute and write calibration    //
+} // of method begin()                                                        //                                  //
+/*******************************************************************************************************************
+** Method startBus starts the transport and then sets the bus clock if one has been selected with setBusClock(),  **
+** since on most platforms starting the bus also resets the clock.                                                **
+*******************************************************************************************************************/
+void INA226_Class::startBus() {                                               // Start the transport and its clock//
+  _Transport->begin();                                                        // Start the I2C bus                //
+  if (_BusClock) _Transport->setClock(_BusClock);                             // and set the clock if selected    //
+} // of method startBus()                                                     //                                  //
+/*******************************************************************************************************************
+** Method probeDevice checks whether there is an INA226 at the address and if so adds it to the device table. If  **
+** resetDevice is set then the device is reset and identified by its default configuration, otherwise its current **
+** configuration is read back and used if the fixed bits 12 to 15 have their expected values. The return value is **
+** true if a device was added.                                                                                    **
+*******************************************************************************************************************/
+bool INA226_Class::probeDevice(const uint8_t deviceAddress,                   // Add device at address to table   //
+                               const bool resetDevice) {                      //                                  //
+  uint16_t configRegister;                                                    // Hold configuration register      //
+  if (_DeviceCount>=INA_MAX_DEVICES) return false;                            // Return if no space left in table //
+  _TransmissionStatus = _Transport->write(deviceAddress,NULL,0);              // See if something is at address   //
+  INA_INSTRUMENT(count(deviceAddress,0,_TransmissionStatus!=0));              //                                  //
+  if (_TransmissionStatus!=0) return false;                                   // by checking the return error     //
+  if (readWord(INA_MANUFACTURER_ID_REGISTER,deviceAddress)!=0x5449)           // Check hard-coded manufacturerId  //
+    return false;                                                             //                                  //
+  if (resetDevice) {                                                          // If the device is to be reset,    //
+    writeWord(INA_CONFIGURATION_REGISTER,INA_RESET_DEVICE,deviceAddress);     // force INA to reset and check that//
+    if (waitForReset(deviceAddress)!=INA_DEFAULT_CONFIGURATION) return false; // it has the default configuration //
+  } else {                                                                    // Otherwise verify the current     //
+    configRegister = readWord(INA_CONFIGURATION_REGISTER,deviceAddress);      // configuration is a valid one     //
+    if ((configRegister&INA_CONFIG_FIXED_MASK)!=                              //                                  //
+        (INA_DEFAULT_CONFIGURATION&INA_CONFIG_FIXED_MASK)) return false;      //                                  //
+  } // of if-then-else reset device                                           //                                  //
+  inaDet &dev = _Devices[_DeviceCount++];                                     // Next table entry, count device   //
+  dev.address = deviceAddress;                                                // Store device address             //
+  if (resetDevice) {                                                          // Shadow of the register values    //
+    dev.configuration = INA_DEFAULT_CONFIGURATION;                            // after the reset                  //
+    dev.maskEnable    = 0;                                                    //                                  //
+    dev.alertLimit    = 0;                                                    //                                  //
+  } else {                                                                    // or the ones read back            //
+    dev.configuration = configRegister;                                       //                                  //
+    dev.maskEnable    = readWord(INA_MASK_ENABLE_REGISTER,deviceAddress)      //                                  //
+                        &INA_ALERT_CONFIG_MASK;                               //                                  //
+    dev.alertLimit    = readWord(INA_ALERT_LIMIT_REGISTER,deviceAddress);     //                                  //
+  } // of if-then-else reset device                                           //                                  //
+  dev.operatingMode = dev.configuration&INA_CONFIG_MODE_MASK;                 // Mode from the configuration      //
+  dev.gain           = INA_GAIN_UNITY;                                        // No correction until measured     //
+  dev.currentOffset  = 0;                                                     //                                  //
+  dev.gainInRegister = false;                                                 //                                  //
+  _ReadyMicros[_DeviceCount-1] = micros()+conversionPeriod(dev.configuration);// First conversion is now running  //
+  INA_LOG(INA_LOG_INFO,INA_EVENT_DEVICE_FOUND,deviceAddress,                  //                                  //
+          dev.configuration);                                                 //                                  //
+  return true;                                                                //                                  //
+} // of method probeDevice()                                                  //                                  //
+/*******************************************************************************************************************
+** Method calibrate computes the current and power LSBs and the calibration register value for the maximum        **
+** expected current and the shunt resistance and writes them to one or all of the devices. It returns the number  **
+** of devices found, which is 0 if there are none to configure.                                                   **
+*******************************************************************************************************************/
+uint8_t INA226_Class::calibrate(const uint8_t maxBusAmps,                     // Compute and write calibration    //
+                                const uint32_t microOhmR,                     //                                  //
+                                const uint8_t deviceNumber) {                 //                                  //
+  inaDet ina;                                                                 // Hold device details in structure //
+  if (_DeviceCount==0) return 0;                                              // Nothing to configure             //
+  ina.current_LSB   = inaCurrentLSB(maxBusAmps);                              // Get the best possible LSB in nA  //
+  ina.calibration   = inaCalibration(ina.current_LSB,microOhmR);              // Compute calibration register     //
+  ina.power_LSB     = (uint32_t)25*ina.current_LSB;                           // Fixed multiplier for INA219      //
+  INA_LOG(INA_LOG_DEBUG,INA_EVENT_CURRENT_LSB,0,ina.current_LSB);             // Computed values, not yet written //
+  INA_LOG(INA_LOG_DEBUG,INA_EVENT_POWER_LSB,0,ina.power_LSB);                 // to a device                      //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
+    if(deviceNumber==UINT8_MAX || deviceNumber%_DeviceCount==i ) {            // If this device needs setting     //
+      _Devices[i].current_LSB = ina.current_LSB;                              // Copy the computed values into    //
+      _Devices[i].calibration = ina.calibration;                              // the table entry, keeping the     //
+      _Devices[i].power_LSB   = ina.power_LSB;                                // address and correction there     //
+      applyCorrection(_Devices[i]);                                           // Multipliers and calibration      //
+    } // of if this device needs to be set                                    //                                  //
+  } // for-next each device loop                                              //                                  //
   return _DeviceCount;                                                        // Return number of devices found   //
+} // of method calibrate()                                                    //                                  //
+/*******************************************************************************************************************
+** Method device() returns the RAM device table entry for a device number. Numbers at or above the number of      **
+** devices found wrap around, as they always have, and the modulo is only computed when actually needed.          **
+*******************************************************************************************************************/
+inaDet& INA226_Class::device(const uint8_t deviceNumber) {                    // Return device table entry        //
+  if (deviceNumber<_DeviceCount) return _Devices[deviceNumber];               // Normal case, no division needed  //
+  return _Devices[_DeviceCount?deviceNumber%_DeviceCount:0];                  // Cater for overflow               //
+} // of method device()                                                       //                                  //
+/*******************************************************************************************************************
+** Method saveConfig() stores the RAM device table in EEPROM at INA_EEPROM_ADDRESS so that it can be restored     **
+** with loadConfig() on the next boot. This is the only method that writes to EEPROM, and since EEPROM.put() only **
+** writes bytes that have changed, saving an unchanged table does not wear out the EEPROM cells.                  **
+*******************************************************************************************************************/
+bool INA226_Class::saveConfig() {                                             // Store device table in EEPROM     //
+  inaEEPROMHeader header;                                                     // Header written before table      //
+  if (INA_EEPROM_ADDRESS+sizeof(header)+_DeviceCount*sizeof(inaDet)           // Return false if the table won't  //
+      >EEPROM.length()) return false;                                         // fit into the EEPROM              //
+  header.signature   = INA_EEPROM_SIGNATURE;                                  // Mark the table as valid          //
+  header.structSize  = sizeof(inaDet);                                        // and the layout used              //
+  header.deviceCount = _DeviceCount;                                          //                                  //
+  EEPROM.put(INA_EEPROM_ADDRESS,header);                                      // Write the header                 //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // For each device write data       //
+    INA_INSTRUMENT(uint32_t startMicros = micros());                          // Time the EEPROM access           //
+    EEPROM.put(INA_EEPROM_ADDRESS+sizeof(header)+i*sizeof(inaDet),            // Write the table entry            //
+               _Devices[i]);                                                  //                                  //
+    INA_INSTRUMENT(_Counters[_Devices[i].address&INA_POINTER_INDEX_MASK].     //                                  //
+                   eepromMicros += micros()-startMicros);                     //                                  //
+  } // of for each device                                                     //                                  //
+  return true;                                                                //                                  //
+} // of method saveConfig()                                                   //                                  //
+/*******************************************************************************************************************
+** Method loadConfig() restores a device table previously stored with saveConfig() and writes the calibration and **
+** configuration registers back to each device. It can be used instead of begin() to skip the device scan at      **
+** startup. The number of devices restored is returned, 0 if there is no valid table in EEPROM.                   **
+*******************************************************************************************************************/
+uint8_t INA226_Class::loadConfig() {                                          // Restore device table from EEPROM //
+  inaEEPROMHeader header;                                                     // Header written before table      //
+  EEPROM.get(INA_EEPROM_ADDRESS,header);                                      // Read the header                  //
+  if (header.signature!=INA_EEPROM_SIGNATURE ||                               // Return if nothing valid has been //
+      header.structSize!=sizeof(inaDet)      ||                               // saved, or if it was saved by a   //
+      header.deviceCount>INA_MAX_DEVICES) return 0;                           // different library version        //
+  startBus();                                                                 // Start the I2C bus                //
+  _DeviceCount = header.deviceCount;                                          //                                  //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // For each device read data        //
+    INA_INSTRUMENT(uint32_t startMicros = micros());                          // Time the EEPROM access           //
+    EEPROM.get(INA_EEPROM_ADDRESS+sizeof(header)+i*sizeof(inaDet),            // Read the table entry             //
+               _Devices[i]);                                                  //                                  //
+    INA_INSTRUMENT(_Counters[_Devices[i].address&INA_POINTER_INDEX_MASK].     //                                  //
+                   eepromMicros += micros()-startMicros);                     //                                  //
+    applyCorrection(_Devices[i]);                                             // Restore the calibration value    //
+    writeConfiguration(_Devices[i]);                                          // Restore the configuration        //
+    writeWord(INA_ALERT_LIMIT_REGISTER,_Devices[i].alertLimit,                // and the alert settings           //
+              _Devices[i].address);                                           //                                  //
+    writeWord(INA_MASK_ENABLE_REGISTER,_Devices[i].maskEnable,                //                                  //
+              _Devices[i].address);                                           //                                  //
+  } // of for each device                                                     //                                  //
+  INA_LOG(INA_LOG_INFO,INA_EVENT_CONFIG_LOADED,0,_DeviceCount);               //                                  //
+  return _DeviceCount;                                                        // Return number of devices loaded  //
+} // of method loadConfig()                                                   //                                  //
+/*******************************************************************************************************************
+** Method calibrateCurrent measures the current register of the device with a known load and stores a correction  **
+** for the error of the shunt in the device table, from where saveConfig() also stores it in EEPROM. It averages  **
+** the given number of conversions, with the device in a mode that measures the shunt. With a referenceMicroAmps  **
+** of 0, and no load connected, the average is stored as the offset correction in current register LSBs.          **
+** Otherwise the reference current is compared with the average after the offset has been removed, and the gain   **
+** correction is set to make them equal. The gain is folded into the current and power multipliers, so it costs   **
+** nothing per sample, or into the calibration register if setCorrectionInRegister() has been used. The offset is **
+** subtracted from the current register in the current conversions, the power register is only corrected for the  **
+** gain. False is returned if the shunt isn't measured, if a conversion takes more than twice its conversion      **
+** time, which means the device has stopped responding, or if the correction would be more than 50%, which        **
+** usually means the reference load isn't connected.                                                              **
+*******************************************************************************************************************/
+bool INA226_Class::calibrateCurrent(const int32_t referenceMicroAmps,         // Measure a reference load and     //
+                                    const uint8_t deviceNumber,               // store the gain or offset         //
+                                    const uint8_t samples) {                  // correction                       //
+  inaDet  &ina        = device(deviceNumber);                                 // Device details from table        //
+  uint16_t mask       = (uint16_t)1<<(&ina-_Devices);                         // Bitmask of the device            //
+  uint32_t waitMicros = 2*conversionPeriod(ina.configuration);                // At most twice the conversion time//
+  int32_t  sum        = 0;                                                    // Sum of the current registers     //
+  if (samples==0 || !bitRead(ina.operatingMode,0)) return false;              // Return if no shunt conversions   //
+  for(uint8_t i=0;i<samples;i++) {                                            // Average the conversions, giving  //
+    if (waitForConversion(waitMicros,mask)==0) return false;                  // up if the device doesn't finish  //
+    sum += readWord(INA_CURRENT_REGISTER,ina.address);                        //                                  //
+    if (!bitRead(ina.operatingMode,2)) writeConfiguration(ina);               // Retrigger in triggered mode      //
+  } // for-next each sample                                                   //                                  //
+  if (referenceMicroAmps==0) {                                                // Without a load the average is    //
+    ina.currentOffset = lround((float)sum/samples);                           // the offset                       //
+    return true;                                                              //                                  //
+  } // of if-then offset                                                      //                                  //
+  float measured = ((float)sum-(float)ina.currentOffset*samples)*             // Sum of the currents, scaled as   //
+                   ina.current_LSB;                                           // in the multipliers               //
+  float gain     = (ina.gainInRegister ? ina.gain : INA_GAIN_UNITY)*          // Gain relative to the one already //
+                   (float)referenceMicroAmps*100000*samples/measured;         // in the calibration register      //
+  if (!(gain>=INA_GAIN_UNITY/2 && gain<=INA_GAIN_UNITY*3/2)) return false;    // Also false if measured was 0     //
+  ina.gain = lround(gain);                                                    //                                  //
+  applyCorrection(ina);                                                       // Use the new gain                 //
+  return true;                                                                //                                  //
+} // of method calibrateCurrent()                                             //                                  //
+/*******************************************************************************************************************
+** Method setCorrection sets the gain and offset corrections of one or all devices directly, for instance with    **
+** values measured on the host. A gain of INA_GAIN_UNITY is 1.0, and the offset is in current register LSBs.      **
+** getCorrection returns the values in use.                                                                       **
+*******************************************************************************************************************/
+void INA226_Class::setCorrection(const uint16_t gain,const int16_t offset,    // Set the correction directly      //
+                                 const uint8_t deviceNumber) {                //                                  //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
+    if(deviceNumber==UINT8_MAX || deviceNumber%_DeviceCount==i ) {            // If this device needs setting     //
+      _Devices[i].gain          = gain;                                       //                                  //
+      _Devices[i].currentOffset = offset;                                     //                                  //
+      applyCorrection(_Devices[i]);                                           //                                  //
+    } // of if this device needs to be set                                    //                                  //
+  } // for-next each device loop                                              //                                  //
+} // of method setCorrection()                                                //                                  //
+void INA226_Class::getCorrection(const uint8_t deviceNumber,uint16_t &gain,   // Get the correction in use        //
+                                 int16_t &offset) {                           //                                  //
+  inaDet &ina = device(deviceNumber);                                         // Device details from table        //
+  gain   = ina.gain;                                                          //                                  //
+  offset = ina.currentOffset;                                                 //                                  //
+} // of method getCorrection()                                                //                                  //
+/*******************************************************************************************************************
+** Method setCorrectionInRegister selects where the gain correction is applied. By default it is folded into the  **
+** multipliers used by the library's conversions. With inRegister set the calibration register is written with    **
+** the corrected value instead and the multipliers are the nominal ones, so the device's own current and power    **
+** registers are corrected as well, without any calculations on the processor.                                    **
+*******************************************************************************************************************/
+void INA226_Class::setCorrectionInRegister(const bool inRegister,             // Correct the gain in the          //
+                                           const uint8_t deviceNumber) {      // calibration register             //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
+    if(deviceNumber==UINT8_MAX || deviceNumber%_DeviceCount==i ) {            // If this device needs setting     //
+      _Devices[i].gainInRegister = inRegister;                                //                                  //
+      applyCorrection(_Devices[i]);                                           //                                  //
+    } // of if this device needs to be set                                    //                                  //
+  } // for-next each device loop                                              //                                  //
+} // of method setCorrectionInRegister()                                      //                                  //
+/*******************************************************************************************************************
+** Method applyCorrection computes the multipliers and shifts of the device from the LSB returned by              **
+** correctedLSB() and writes the value from correctedCalibration() to the calibration register, so that the gain  **
+** correction is applied in exactly one of the two places.                                                        **
+*******************************************************************************************************************/
+void INA226_Class::applyCorrection(inaDet &ina) {                             // Set multipliers and calibration  //
+  uint32_t currentLSB  = correctedLSB(ina);                                   // LSB used by the conversions      //
+  uint16_t calibration = correctedCalibration(ina);                           // Value for the register           //
+  ina.current_Shift = inaScaleShift(currentLSB,100000);                       // Turn the LSBs into multipliers   //
+  ina.current_Mult  = inaScaleMultiplier(currentLSB,100000,ina.current_Shift);// and shifts for the conversions,  //
+  ina.power_Shift   = inaScaleShift((uint32_t)25*currentLSB,1000);            // so that no divisions are needed  //
+  ina.power_Mult    = inaScaleMultiplier((uint32_t)25*currentLSB,1000,        //                                  //
+                                         ina.power_Shift);                    //                                  //
+  writeWord(INA_CALIBRATION_REGISTER,calibration,ina.address);                // Write the calibration value      //
+  INA_LOG(INA_LOG_DEBUG,INA_EVENT_CALIBRATION,ina.address,calibration);       //                                  //
+} // of method applyCorrection()                                              //                                  //
+/*******************************************************************************************************************
+** Methods correctedLSB and correctedCalibration return the current LSB used by the conversions and the value     **
+** written to the calibration register, with the gain correction applied to one of them. If the gain is corrected **
+** in the register, the calibration value is scaled by the gain and limited to the 15 bits of the register,       **
+** otherwise the LSB is scaled.                                                                                   **
+*******************************************************************************************************************/
+uint32_t INA226_Class::correctedLSB(const inaDet &ina) {                      // Current LSB with gain correction //
+  if (ina.gainInRegister) return ina.current_LSB;                             // Nominal if gain is in register   //
+  return ((uint64_t)ina.current_LSB*ina.gain+INA_GAIN_UNITY/2)>>15;           //                                  //
+} // of method correctedLSB()                                                 //                                  //
+uint16_t INA226_Class::correctedCalibration(const inaDet &ina) {              // Calibration with gain correction //
+  if (!ina.gainInRegister) return ina.calibration;                            // Nominal unless gain in register  //
+  uint32_t calibration = ((uint32_t)ina.calibration*ina.gain+                 // Scale by the gain with rounding  //
+                          INA_GAIN_UNITY/2)>>15;                              //                                  //
+  return (calibration>0x7FFF) ? 0x7FFF : calibration;                         // Register only has 15 bits        //
+} // of method correctedCalibration()                                         //                                  //
+/*******************************************************************************************************************
+** Method microAmps converts a current register value of the device to microamps, after removing the offset       **
+** correction. The subtraction is done in 32 bits so that it can't overflow.                                      **
+*******************************************************************************************************************/
+int32_t INA226_Class::microAmps(const inaDet &ina,const int16_t currentRaw) { // Current with offset correction   //
+  return (((int32_t)currentRaw-ina.currentOffset)*(int32_t)ina.current_Mult)>>//                                  //
+         ina.current_Shift;                                                   //                                  //
+} // of method microAmps()                                                    //                                  //
+/*******************************************************************************************************************
+** Method setI2CDelay sets the number of microseconds to wait between setting the register pointer and reading    **
+** the value. The INA226 doesn't need this delay, so it can be set to 0. If INA_NO_I2C_DELAY has been defined     **
+** then the delay has been removed from the code and this call has no effect.                                     **
+*******************************************************************************************************************/
+void INA226_Class::setI2CDelay(const uint8_t microSeconds) {                  // Set delay before reading a value //
+  _I2CDelay = microSeconds;                                                   // Store the new value              //
+} // of method setI2CDelay()                                                  //                                  //
+/*******************************************************************************************************************
+** Method waitForReset polls the configuration register of a device that has just been reset until the reset bit  **
+** is cleared, but for no longer than INA_RESET_TIMEOUT milliseconds. This replaces a fixed delay after each      **
+** reset. The last configuration register value read is returned.                                                 **
+*******************************************************************************************************************/
+uint16_t INA226_Class::waitForReset(const uint8_t deviceAddr) {               // Wait until device reset is done  //
+  uint16_t configRegister;                                                    // Hold configuration register      //
+  uint32_t startMillis = millis();                                            // Start time of the wait           //
+  do {                                                                        // Loop until reset bit is cleared  //
+    configRegister = readWord(INA_CONFIGURATION_REGISTER,deviceAddr);         // or the timeout is reached        //
+  } while ((configRegister&INA_RESET_DEVICE) &&                               //                                  //
+           millis()-startMillis<INA_RESET_TIMEOUT);                           //                                  //
+  return configRegister;                                                      // Return the register value        //
+} // of method waitForReset()                                                 //                                  //
+/*******************************************************************************************************************
+** Method setPointer sets the register pointer of a device prior to reading. The pointer written last to each     **
+** device is remembered, and when fast-poll mode has been turned on using setFastPoll() the pointer write is      **
+** skipped if the device is already pointing at the requested register.                                           **
+*******************************************************************************************************************/
+void INA226_Class::setPointer(const uint8_t addr,const uint8_t deviceAddr) {  // Set the device register pointer  //
+  uint8_t &pointer = _RegisterPointer[deviceAddr&INA_POINTER_INDEX_MASK];     // Last pointer set on this address //
+  if (_FastPoll && pointer==addr) return;                                     // Nothing to do if already set     //
+  _TransmissionStatus = _Transport->write(deviceAddr,&addr,1);                // Send the register address to read//
+  INA_INSTRUMENT(count(deviceAddr,1,_TransmissionStatus!=0));                 //                                  //
+  #ifndef INA_NO_I2C_DELAY                                                    // Unless delay is compiled out     //
+    if (_I2CDelay) delayMicroseconds(_I2CDelay);                              // delay if one has been set        //
+  #endif                                                                      //                                  //
+  pointer = (_TransmissionStatus==0) ? addr : INA_POINTER_UNKNOWN;            // Remember pointer if write worked //
+} // of method setPointer()                                                   //                                  //
+/*******************************************************************************************************************
+** Method setFastPoll turns the fast-poll mode on or off. In fast-poll mode repeated reads from the same register **
+** of a device only send the read request, since the INA226 keeps the register pointer between transactions. This **
+** roughly halves the bus time used when streaming a single register. It should not be used if something else on  **
+** the I2C bus also talks to the INA226 devices.                                                                  **
+*******************************************************************************************************************/
+void INA226_Class::setFastPoll(const bool fastPoll) {                         // Turn register pointer caching on //
+  for(uint8_t i=0;i<sizeof(_RegisterPointer);i++) {                           // Forget all pointers, since they  //
+    _RegisterPointer[i] = INA_POINTER_UNKNOWN;                                // might have changed meanwhile     //
+  } // for-next each possible address                                         //                                  //
+  _FastPoll = fastPoll;                                                       // Store the new setting            //
+} // of method setFastPoll()                                                  //                                  //
+/*******************************************************************************************************************
+** Method setWire makes the class use another TwoWire instance, for example a second I2C bus, instead of the      **
+** global Wire object. It needs to be called before begin() or loadConfig().                                      **
+*******************************************************************************************************************/
+void INA226_Class::setWire(TwoWire &wire) {                                   // Use another I2C bus              //
+  _WireTransport = INA226_WireTransport(wire);                                // Point the default transport at it//
+  setTransport(_WireTransport);                                               //                                  //
+} // of method setWire()                                                      //                                  //
+/*******************************************************************************************************************
+** Method setTransport makes the class do all its register reads and writes through the transport, see the        **
+** INA226_Transport declaration. It needs to be called before begin() or loadConfig(), and the transport must not **
+** be shared with another INA226_Class instance.                                                                  **
+*******************************************************************************************************************/
+void INA226_Class::setTransport(INA226_Transport &transport) {                // Use another transport            //
+  _Transport         = &transport;                                            // Store the new transport and make//
+  _Transport->_Owner = this;                                                  // this class its owner             //
+  setFastPoll(_FastPoll);                                                     // Pointers on the new bus unknown  //
+} // of method setTransport()                                                 //                                  //
+/*******************************************************************************************************************
+** Method setBusClock selects the I2C bus clock in Hz, for example INA_I2C_FAST_MODE or INA_I2C_FAST_MODE_PLUS.   **
+** Clocks above Fast-mode Plus, up to the INA226's INA_I2C_HIGH_SPEED_MODE, use HS mode on transports that        **
+** support it. It can be called before begin(), which then sets the clock after starting the bus, or afterwards.  **
+** The return value is false, and the clock is left unchanged, if the transport can't produce the clock. The      **
+** clock really reached depends on the platform, and all other devices on the bus must support it.                **
+*******************************************************************************************************************/
+bool INA226_Class::setBusClock(const uint32_t clockHz) {                      // Select the I2C bus clock         //
+  if (!_Transport->setClock(clockHz)) return false;                           // Set it now, and if the transport //
+  _BusClock = clockHz;                                                        // accepted it remember it for      //
+  return true;                                                                // begin()                          //
+} // of method setBusClock()                                                  //                                  //
+/*******************************************************************************************************************
+** Method readRawAsync reads the 4 measurement registers of each of the devices selected in the deviceMask        **
+** bitmask, which can be INA_ALL_DEVICES, into consecutive elements of the samples array in the background. The   **
+** samples array needs space for one sample per selected device. As with readRegisters() the Conversion Ready     **
+** flag is neither checked nor reset, so the reads are timed with triggerAll() or nextReadyMicros(). With a       **
+** transport whose startRead() runs in the background each register read is started from the completion of the    **
+** one before, and the callback is called, usually from the interrupt handler of the transport, once all the      **
+** samples have been read or a read failed. The count passed is the number of complete samples and the status is  **
+** 0 if all went well. The return value is false if a background read is still running, in which case nothing is  **
+** started. No other calls may be made on the class until asyncBusy() returns false.                              **
+*******************************************************************************************************************/
+bool INA226_Class::readRawAsync(INA226_Sample samples[],                      // Read devices in the background   //
+                                INA226_AsyncCallback callback,                //                                  //
+                                const uint16_t deviceMask) {                  //                                  //
+  if (_AsyncBusy || callback==NULL) return false;                             // Only one at a time               //
+  _AsyncBusy     = true;                                                      //                                  //
+  _AsyncSamples  = samples;                                                   // Store the request                //
+  _AsyncCallback = callback;                                                  //                                  //
+  _AsyncMask     = deviceMask;                                                //                                  //
+  _AsyncDevice   = 0;                                                         //                                  //
+  _AsyncRegister = 0;                                                         //                                  //
+  _AsyncCount    = 0;                                                         //                                  //
+  asyncNext(0);                                                               // Start the first register read    //
+  return true;                                                                //                                  //
+} // of method readRawAsync()                                                 //                                  //
+/*******************************************************************************************************************
+** Method asyncBusy returns true while a readRawAsync() request is still running.                                 **
+*******************************************************************************************************************/
+bool INA226_Class::asyncBusy() {                                              // True while readRawAsync() runs   //
+  return _AsyncBusy;                                                          //                                  //
+} // of method asyncBusy()                                                    //                                  //
+/*******************************************************************************************************************
+** Method asyncComplete is called through INA226_Transport::complete() when a background register read has        **
+** finished. It stores the value and starts the next read.                                                        **
+*******************************************************************************************************************/
+void INA226_Class::asyncComplete(const uint8_t status) {                      // Background read has finished     //
+  if (!_AsyncBusy) return;                                                    // Ignore stray completions         //
+  if (status==0) asyncStore();                                                // Store the value if it worked     //
+  asyncNext(status);                                                          // Start the next read              //
+} // of method asyncComplete()                                                //                                  //
+/*******************************************************************************************************************
+** Method asyncNext starts register reads until one is running in the background, or until all of the selected    **
+** devices have been read or a read failed, in which case the callback is called. Reads done at once by           **
+** startRead() are handled in the loop rather than by recursion, so a blocking transport doesn't use up the       **
+** stack.                                                                                                         **
+*******************************************************************************************************************/
+void INA226_Class::asyncNext(uint8_t status) {                                // Start the next background read   //
+  while (status==0) {                                                         // Loop while the reads succeed     //
+    if (_AsyncRegister==0) {                                                  // If a new sample is needed, find  //
+      while (_AsyncDevice<_DeviceCount && !bitRead(_AsyncMask,_AsyncDevice)) {// the next selected device         //
+        _AsyncDevice++;                                                       //                                  //
+      } // of while device not selected                                       //                                  //
+      if (_AsyncDevice>=_DeviceCount) break;                                  // Done if there are no more        //
+      _AsyncSamples[_AsyncCount].deviceNumber = _AsyncDevice;                 // Start the sample                 //
+      _AsyncSamples[_AsyncCount].deltaMicros  = 0;                            //                                  //
+      _AsyncRegister = INA_SHUNT_VOLTAGE_REGISTER;                            // with the first register          //
+    } // of if-then new sample                                                //                                  //
+    status = _Transport->startRead(_Devices[_AsyncDevice].address,            // Start reading the register       //
+                                   _AsyncRegister,_AsyncData);                //                                  //
+    if (status==INA_TRANSFER_PENDING) return;                                 // complete() will carry on         //
+    if (status==0) asyncStore();                                              // Read already done, store it      //
+  } // of while reads succeed                                                 //                                  //
+  if (status!=0) {                                                            // If a read failed the pointer of  //
+    _RegisterPointer[_Devices[_AsyncDevice].address&INA_POINTER_INDEX_MASK]=  // the device is not known          //
+      INA_POINTER_UNKNOWN;                                                    //                                  //
+    INA_INSTRUMENT(count(_Devices[_AsyncDevice].address,0,true));             //                                  //
+  } // of if-then read failed                                                 //                                  //
+  _AsyncBusy = false;                                                         // Request is finished              //
+  _AsyncCallback(_AsyncSamples,_AsyncCount,status);                           //                                  //
+} // of method asyncNext()                                                    //                                  //
+/*******************************************************************************************************************
+** Method asyncStore stores the value of the register just read in the sample and moves on to the next register,  **
+** or to the next device after the last one.                                                                      **
+*******************************************************************************************************************/
+void INA226_Class::asyncStore() {                                             // Store a background read value    //
+  INA226_Sample &sample = _AsyncSamples[_AsyncCount];                         // Sample being read                //
+  int16_t value = (int16_t)(_AsyncData[0]<<8|_AsyncData[1]);                  // Register value, msb first        //
+  switch (_AsyncRegister) {                                                   // Store in the matching field      //
+    case INA_SHUNT_VOLTAGE_REGISTER: sample.shuntRaw   = value; break;        //                                  //
+    case INA_BUS_VOLTAGE_REGISTER:   sample.busRaw     = value; break;        //                                  //
+    case INA_POWER_REGISTER:         sample.powerRaw   = value; break;        //                                  //
+    case INA_CURRENT_REGISTER:       sample.currentRaw = value; break;        //                                  //
+  } // of switch register                                                     //                                  //
+  _RegisterPointer[_Devices[_AsyncDevice].address&INA_POINTER_INDEX_MASK]=    // The read moved the pointer       //
+    _AsyncRegister;                                                           //                                  //
+  INA_INSTRUMENT(count(_Devices[_AsyncDevice].address,1,false));              // Pointer write and read of the    //
+  INA_INSTRUMENT(count(_Devices[_AsyncDevice].address,2,false));              // 2 bytes                          //
+  if (++_AsyncRegister>INA_CURRENT_REGISTER) {                                // After the last register the      //
+    _AsyncRegister = 0;                                                       // sample is complete               //
+    _AsyncCount++;                                                            //                                  //
+    _AsyncDevice++;                                                           //                                  //
+  } // of if-then last register                                               //                                  //
+} // of method asyncStore()                                                   //                                  //
+/*******************************************************************************************************************
+** Method begin of INA226_Transport starts the bus, the default does nothing.                                     **
+*******************************************************************************************************************/
+void INA226_Transport::begin() {}                                             // Start the bus                    //
+/*******************************************************************************************************************
+** Method setClock of INA226_Transport sets the bus clock in Hz, the default can't and returns false.             **
+*******************************************************************************************************************/
+bool INA226_Transport::setClock(const uint32_t) {                             // Set bus clock, false if it can't //
+  return false;                                                               //                                  //
+} // of method setClock()                                                     //                                  //
+/*******************************************************************************************************************
+** Method startRead of INA226_Transport reads 2 bytes from register addr of the device into data. The default     **
+** uses write() and read() and is done when it returns, the return value being the Wire status. Asynchronous      **
+** backends override it to start the transfer and return INA_TRANSFER_PENDING, and then call complete() once it   **
+** has finished.                                                                                                  **
+*******************************************************************************************************************/
+uint8_t INA226_Transport::startRead(const uint8_t deviceAddress,              // Start a 2 byte register read     //
+                                    const uint8_t addr,uint8_t data[]) {      //                                  //
+  uint8_t status = write(deviceAddress,&addr,1);                              // Set the register pointer         //
+  if (status==0 && read(deviceAddress,data,2)!=2) status=INA_TRANSFER_ERROR;  // and read the 2 bytes             //
+  return status;                                                              // Return the Wire status           //
+} // of method startRead()                                                    //                                  //
+/*******************************************************************************************************************
+** Method complete of INA226_Transport is called by asynchronous backends with the Wire status when a transfer    **
+** started by startRead() has finished.                                                                           **
+*******************************************************************************************************************/
+void INA226_Transport::complete(const uint8_t status) {                       // startRead() transfer has finished//
+  if (_Owner!=NULL) _Owner->asyncComplete(status);                            // Let the class carry on           //
+} // of method complete()                                                     //                                  //
+/*******************************************************************************************************************
+** The INA226_WireTransport methods use a TwoWire instance, by default the global Wire object.                    **
+*******************************************************************************************************************/
+INA226_WireTransport::INA226_WireTransport(TwoWire &wire) : _Wire(&wire) {}   // Class constructor                //
+void INA226_WireTransport::begin() {                                          // Start the bus                    //
+  _Wire->begin();                                                             //                                  //
 } // of method begin()                                                        //                                  //
 /*******************************************************************************************************************
+** Method setClock of INA226_WireTransport sets the clock of the TwoWire instance. HS mode, for clocks above      **
+** INA_I2C_FAST_MODE_PLUS, ends with every STOP condition, so in HS mode each transfer is preceded by the master  **
+** code, sent at INA_I2C_FAST_MODE and not acknowledged by any device, and a repeated START at the HS clock. Most **
+** Wire libraries, for example the AVR one, send a STOP when the address isn't acknowledged even if               **
+** endTransmission(false) was used, which ends HS mode straight away. HS clocks are therefore refused with false  **
+** unless INA_WIRE_HS_MODE is defined for a Wire library that keeps the bus and whose setClock() may be called    **
+** between the two. On AVR processors clocks that the 8 bit TWBR divider can't produce are refused as well, which **
+** includes all HS clocks.                                                                                        **
+*******************************************************************************************************************/
+bool INA226_WireTransport::setClock(const uint32_t clockHz) {                 // Set bus clock, HS mode above 1MHz//
+  bool highSpeed = clockHz>INA_I2C_FAST_MODE_PLUS;                            // HS mode needs the master code    //
+  #ifndef INA_WIRE_HS_MODE                                                    // Most Wire libraries send a STOP  //
+    if (highSpeed) return false;                                              // after the NACK, which ends HS    //
+  #endif                                                                      // mode again at once               //
+  #if defined(__AVR__)                                                        // The AVR TWI clock is F_CPU/(16+  //
+    if (clockHz>F_CPU/16 || clockHz<F_CPU/(16+2*255)) return false;           // 2*TWBR), with an 8 bit TWBR      //
+  #endif                                                                      //                                  //
+  _Clock     = clockHz;                                                       // Store the new clock              //
+  _HighSpeed = highSpeed;                                                     //                                  //
+  _Wire->setClock(_HighSpeed ? INA_I2C_FAST_MODE : clockHz);                  // Clock until the next transfer    //
+  return true;                                                                //                                  //
+} // of method setClock()                                                     //                                  //
+void INA226_WireTransport::enterHighSpeed() {                                 // Send the HS mode master code     //
+  if (!_HighSpeed) return;                                                    // Nothing to do unless in HS mode  //
+  _Wire->setClock(INA_I2C_FAST_MODE);                                         // The master code is sent at       //
+  _Wire->beginTransmission(INA_HS_MASTER_CODE>>1);                            // 400kHz and never acknowledged,   //
+  _Wire->endTransmission(false);                                              // so ignore the status, no STOP    //
+  _Wire->setClock(_Clock);                                                    // Rest of the transfer at HS clock //
+} // of method enterHighSpeed()                                               //                                  //
+uint8_t INA226_WireTransport::write(const uint8_t deviceAddress,              // Write bytes, return Wire status  //
+                                    const uint8_t data[],                     //                                  //
+                                    const uint8_t length) {                   //                                  //
+  enterHighSpeed();                                                           // Switch to HS mode if selected    //
+  _Wire->beginTransmission(deviceAddress);                                    // Address the I2C device           //
+  for(uint8_t i=0;i<length;i++) _Wire->write(data[i]);                        // Send the bytes                   //
+  return _Wire->endTransmission();                                            // Close transmission               //
+} // of method write()                                                        //                                  //
+uint8_t INA226_WireTransport::read(const uint8_t deviceAddress,uint8_t data[],// Read bytes, return number read   //
+                                   const uint8_t length) {                    //                                  //
+  enterHighSpeed();                                                           // Switch to HS mode if selected    //
+  uint8_t received = _Wire->requestFrom(deviceAddress,length);                // Request consecutive bytes        //
+  for(uint8_t i=0;i<received && i<length;i++) data[i] = _Wire->read();        // and read them                    //
+  return received;                                                            //                                  //
+} // of method read()                                                         //                                  //
+/*******************************************************************************************************************
+** Method startRead of INA226_WireTransport sets the register pointer and reads the 2 bytes using a repeated      **
+** START, so that HS mode only has to be entered once for the whole read.                                         **
+*******************************************************************************************************************/
+uint8_t INA226_WireTransport::startRead(const uint8_t deviceAddress,          // Register read with repeated start//
+                                        const uint8_t addr,uint8_t data[]) {  //                                  //
+  enterHighSpeed();                                                           // Switch to HS mode if selected    //
+  _Wire->beginTransmission(deviceAddress);                                    // Address the I2C device           //
+  _Wire->write(addr);                                                         // Send the register address to read//
+  uint8_t status = _Wire->endTransmission(false);                             // Keep the bus, no STOP            //
+  if (status==0 && _Wire->requestFrom(deviceAddress,(uint8_t)2)==2) {         // Read the 2 bytes, msb first      //
+    data[0] = _Wire->read();                                                  //                                  //
+    data[1] = _Wire->read();                                                  //                                  //
+  } else if (status==0) {                                                     //                                  //
+    status = INA_TRANSFER_ERROR;                                              // Fewer bytes than requested       //
+  } // of if-then-else read                                                   //                                  //
+  return status;                                                              // Return the Wire status           //
+} // of method startRead()                                                    //                                  //
+/*******************************************************************************************************************
 ** Method readByte reads 1 byte from the specified address                                                        **
 *******************************************************************************************************************/
 uint8_t INA226_Class::readByte(const uint8_t addr,const uint8_t deviceAddr){  //                                  //
-  Wire.beginTransmission(deviceAddr);                                         // Address the I2C device           //
-  Wire.write(addr);                                                           // Send the register address to read//
-  _TransmissionStatus = Wire.endTransmission();                               // Close transmission               //
-  delayMicroseconds(I2C_DELAY);                                               // delay required for sync          //
-  Wire.requestFrom(deviceAddr, (uint8_t)1);                                   // Request 1 byte of data           //
-  return Wire.read();                                                         // read it and return it            //
+  uint8_t data = 0xFF;                                                        // Value if the read fails          //
+  setPointer(addr,deviceAddr);                                                // Point to the register to read    //
+  uint8_t received = _Transport->read(deviceAddr,&data,1);                    // Read 1 byte of data              //
+  INA_INSTRUMENT(count(deviceAddr,received,received!=1));                     //                                  //
+  if (received!=1)                                                            // Short read, value is the bytes   //
+    INA_LOG(INA_LOG_ERROR,INA_EVENT_I2C_ERROR,deviceAddr,received);           //                                  //
+  (void)received;                                                             // Only used when instrumented      //
+  return data;                                                                // and return it                    //
 } // of method readByte()                                                     //                                  //
 /*******************************************************************************************************************
 ** Method readWord reads 2 bytes from the specified address                                                       **
 *******************************************************************************************************************/
 int16_t INA226_Class::readWord(const uint8_t addr,const uint8_t deviceAddr){  //                                  //
-  int16_t returnData;                                                         // Store return value               //
-  Wire.beginTransmission(deviceAddr);                                         // Address the I2C device           //
-  Wire.write(addr);                                                           // Send the register address to read//
-  _TransmissionStatus = Wire.endTransmission();                               // Close transmission               //
-  delayMicroseconds(I2C_DELAY);                                               // delay required for sync          //
-  Wire.requestFrom(deviceAddr, (uint8_t)2);                                   // Request 2 consecutive bytes      //
-  returnData = Wire.read();                                                   // Read the msb                     //
-  returnData = returnData<<8;                                                 // shift the data over              //
-  returnData|= Wire.read();                                                   // Read the lsb                     //
-  return returnData;                                                          // read it and return it            //
+  uint8_t data[2] = {0xFF,0xFF};                                              // Value if the read fails          //
+  setPointer(addr,deviceAddr);                                                // Point to the register to read    //
+  uint8_t received = _Transport->read(deviceAddr,data,2);                     // Read 2 consecutive bytes         //
+  INA_INSTRUMENT(count(deviceAddr,received,received!=2));                     //                                  //
+  if (received!=2)                                                            // Short read, value is the bytes   //
+    INA_LOG(INA_LOG_ERROR,INA_EVENT_I2C_ERROR,deviceAddr,received);           //                                  //
+  (void)received;                                                             // Only used when instrumented      //
+  return (int16_t)(data[0]<<8|data[1]);                                       // msb first and return them        //
 } // of method readWord()                                                     //                                  //
 /*******************************************************************************************************************
 ** Method writeByte write 1 byte to the specified address                                                         **
 *******************************************************************************************************************/
 void INA226_Class::writeByte(const uint8_t addr, const uint8_t data,          //                                  //
                              const uint8_t deviceAddr) {                      //                                  //
-  Wire.beginTransmission(deviceAddr);                                         // Address the I2C device           //
-  Wire.write(addr);                                                           // Send register address to write   //
-  Wire.write(data);                                                           // Send the data to write           //
-  _TransmissionStatus = Wire.endTransmission();                               // Close transmission               //
+  const uint8_t buffer[2] = {addr,data};                                      // Register address and data        //
+  _TransmissionStatus = _Transport->write(deviceAddr,buffer,2);               // Send them to the I2C device      //
+  INA_INSTRUMENT(count(deviceAddr,2,_TransmissionStatus!=0));                 //                                  //
+  if (_TransmissionStatus!=0)                                                 // Failed write, value is the Wire  //
+    INA_LOG(INA_LOG_ERROR,INA_EVENT_I2C_ERROR,deviceAddr,_TransmissionStatus);// status                           //
+  _RegisterPointer[deviceAddr&INA_POINTER_INDEX_MASK] =                       // The write has also moved the     //
+    (_TransmissionStatus==0) ? addr : INA_POINTER_UNKNOWN;                    // device register pointer          //
 } // of method writeByte()                                                    //                                  //
 /*******************************************************************************************************************
 ** Method writeWord writes 2 byte to the specified address                                                        **
 *******************************************************************************************************************/
 void INA226_Class::writeWord(const uint8_t addr, const uint16_t data,         //                                  //
                             const uint8_t deviceAddr) {                       //                                  //
-  Wire.beginTransmission(deviceAddr);                                         // Address the I2C device           //
-  Wire.write(addr);                                                           // Send register address to write   //
-  Wire.write((uint8_t)(data>>8));                                             // Write the first byte             //
-  Wire.write((uint8_t)data);                                                  // and then the second              //
-  _TransmissionStatus = Wire.endTransmission();                               // Close transmission               //
+  const uint8_t buffer[3] = {addr,(uint8_t)(data>>8),(uint8_t)data};          // Register address and data, msb   //
+  _TransmissionStatus = _Transport->write(deviceAddr,buffer,3);               // first, sent to the I2C device    //
+  INA_INSTRUMENT(count(deviceAddr,3,_TransmissionStatus!=0));                 //                                  //
+  if (_TransmissionStatus!=0)                                                 // Failed write, value is the Wire  //
+    INA_LOG(INA_LOG_ERROR,INA_EVENT_I2C_ERROR,deviceAddr,_TransmissionStatus);// status                           //
+  _RegisterPointer[deviceAddr&INA_POINTER_INDEX_MASK] =                       // The write has also moved the     //
+    (_TransmissionStatus==0) ? addr : INA_POINTER_UNKNOWN;                    // device register pointer          //
 } // of method writeWord()                                                    //                                  //
 /*******************************************************************************************************************
 ** Method getBusMilliVolts retrieves the bus voltage measurement                                                  **
 *******************************************************************************************************************/
 uint16_t INA226_Class::getBusMilliVolts(const bool waitSwitch,                //                                  //
                                         const uint8_t deviceNumber) {         //                                  //
-  inaDet ina;                                                                 // Hold device details in structure //
-  EEPROM.get((deviceNumber%_DeviceCount)*sizeof(ina),ina);                    // Read EEPROM values               //
-  if (waitSwitch) waitForConversion();                                        // wait for conversion to complete  //
+  inaDet &ina = device(deviceNumber);                                         // Device details from table        //
+  if (waitSwitch) waitForConversion(deviceNumber);                            // wait for this device to complete //
   uint16_t busVoltage = readWord(INA_BUS_VOLTAGE_REGISTER,ina.address);       // Get the raw value and apply      //
   busVoltage = (uint32_t)busVoltage*INA_BUS_VOLTAGE_LSB/100;                  // conversion to get milliVolts     //
   if (!bitRead(ina.operatingMode,2) && bitRead(ina.operatingMode,1)) {        // If triggered mode and bus active //
-    int16_t configRegister = readWord(INA_CONFIGURATION_REGISTER,ina.address);// Get the current register         //
-    writeWord(INA_CONFIGURATION_REGISTER,configRegister,ina.address);         // Write back to trigger next       //
+    writeConfiguration(ina);                                                  // Write shadow to trigger next     //
   } // of if-then triggered mode enabled                                      //                                  //
   return(busVoltage);                                                         // return computed milliVolts       //
 } // of method getBusMilliVolts()                                             //                                  //
@@ -137,15 +679,12 @@ uint16_t INA226_Class::getBusMilliVolts(const bool waitSwitch,                //
 *******************************************************************************************************************/
 int16_t INA226_Class::getShuntMicroVolts(const bool waitSwitch,               //                                  //
                                          const uint8_t deviceNumber) {        //                                  //
-  inaDet ina;                                                                 // Hold device details in structure //
-  EEPROM.get((deviceNumber%_DeviceCount)*sizeof(ina),ina);                    // Read EEPROM values               //
-  if (waitSwitch) waitForConversion();                                        // wait for conversion to complete  //
+  inaDet &ina = device(deviceNumber);                                         // Device details from table        //
+  if (waitSwitch) waitForConversion(deviceNumber);                            // wait for this device to complete //
   int32_t shuntVoltage = readWord(INA_SHUNT_VOLTAGE_REGISTER,ina.address);    // Get the raw value                //
-Serial.print("shuntVoltageRaw = ");Serial.println(shuntVoltage);
   shuntVoltage = shuntVoltage*INA_SHUNT_VOLTAGE_LSB/10;                       // Convert to microvolts            //
   if (!bitRead(ina.operatingMode,2) && bitRead(ina.operatingMode,0)) {        // If triggered and shunt active    //
-    int16_t configRegister = readWord(INA_CONFIGURATION_REGISTER,ina.address);// Get the current register         //
-    writeWord(INA_CONFIGURATION_REGISTER,configRegister,ina.address);         // Write back to trigger next       //
+    writeConfiguration(ina);                                                  // Write shadow to trigger next     //
   } // of if-then triggered mode enabled                                      //                                  //
   return((int16_t)shuntVoltage);                                              // return computed microvolts       //
 } // of method getShuntMicroVolts()                                           //                                  //
@@ -153,63 +692,183 @@ Serial.print("shuntVoltageRaw = ");Serial.println(shuntVoltage);
 ** Method getBusMicroAmps retrieves the computed current in microamps.                                            **
 *******************************************************************************************************************/
 int32_t INA226_Class::getBusMicroAmps(const uint8_t deviceNumber) {           //                                  //
-  inaDet ina;                                                                 // Hold device details in structure //
-  EEPROM.get((deviceNumber%_DeviceCount)*sizeof(ina),ina);                    // Read EEPROM values               //
-  int32_t microAmps = readWord(INA_CURRENT_REGISTER,ina.address);             // Get the raw value                //
-
-Serial.print("BusCurrentRaw = ");Serial.println(microAmps);
-          microAmps = (int64_t)microAmps*ina.current_LSB/100000;                // Convert to microamps             //
-  return(microAmps);                                                          // return computed microamps        //
+  inaDet &ina = device(deviceNumber);                                         // Device details from table        //
+  return microAmps(ina,readWord(INA_CURRENT_REGISTER,ina.address));           // Convert the raw value            //
 } // of method getBusMicroAmps()                                              //                                  //
 /*******************************************************************************************************************
 ** Method getBusMicroWatts retrieves the computed power in milliwatts                                             **
 *******************************************************************************************************************/
 int32_t INA226_Class::getBusMicroWatts(const uint8_t deviceNumber) {          //                                  //
-  inaDet ina;                                                                 // Hold device details in structure //
-  EEPROM.get((deviceNumber%_DeviceCount)*sizeof(ina),ina);                    // Read EEPROM values               //
+  inaDet &ina = device(deviceNumber);                                         // Device details from table        //
   int32_t microWatts = readWord(INA_POWER_REGISTER,ina.address);              // Get the raw value                //
-          microWatts = (int64_t)microWatts*ina.power_LSB/1000;                // Convert to milliwatts            //
+          microWatts = ((uint32_t)microWatts*ina.power_Mult)>>ina.power_Shift;// Convert to milliwatts            //
   return(microWatts);                                                         // return computed milliwatts       //
 } // of method getBusMicroWatts()                                             //                                  //
 /*******************************************************************************************************************
+** Method readAll retrieves the bus voltage, shunt voltage, current and power of one device in a single call. The **
+** raw values are read using readSample() and then converted using convertSample(). If the waitSwitch is set then **
+** the method first waits for the conversion to finish. The return value is true if the values came from a        **
+** conversion not previously read.                                                                                **
+*******************************************************************************************************************/
+bool INA226_Class::readAll(const uint8_t deviceNumber,INA226_Reading &reading,// Retrieve all measurements at once//
+                           const bool waitSwitch) {                           //                                  //
+  INA226_Sample sample;                                                       // Hold raw register values         //
+  bool newData = readSample(deviceNumber,sample,waitSwitch);                  // Read the device                  //
+  convertSample(sample,reading);                                              // and convert the values           //
+  return(newData);                                                            // Return true if the data is new   //
+} // of method readAll()                                                      //                                  //
+/*******************************************************************************************************************
+** Method readSample reads the 4 raw measurement registers of one device. The device table lookup is only done    **
+** once and the Conversion Ready flag is checked just once before the 4 registers are read back-to-back, so that  **
+** all the values come from the same conversion. In triggered mode the next conversion is started once all the    **
+** values of a new conversion have been read. If the conversion isn't ready yet the configuration register is     **
+** left alone, since writing it would abort the conversion that is running. In continuous mode the time the next  **
+** conversion is expected is stepped by one conversion period from the previous one, since the device keeps       **
+** converting regardless of when it is read, and only set from the current time when it has fallen a period or    **
+** more behind. The deltaMicros field is not set. The return value is true if the conversion had not been read    **
+** yet.                                                                                                           **
+*******************************************************************************************************************/
+bool INA226_Class::readSample(const uint8_t deviceNumber,                     // Read all 4 raw registers         //
+                              INA226_Sample &sample,                          //                                  //
+                              const bool waitSwitch) {                        //                                  //
+  inaDet &ina = device(deviceNumber);                                         // Device details from table        //
+  uint16_t conversionBits = readWord(INA_MASK_ENABLE_REGISTER,ina.address)    // Check and reset the conversion   //
+                            &INA_CONVERSION_READY_MASK;                       // ready flag                       //
+  while(waitSwitch && conversionBits==0) {                                    // Loop until conversion is done    //
+    conversionBits = readWord(INA_MASK_ENABLE_REGISTER,ina.address)           //                                  //
+                     &INA_CONVERSION_READY_MASK;                              //                                  //
+  } // of while the conversion hasn't finished                                //                                  //
+  readRegisters(ina,sample);                                                  // Read the 4 raw register values   //
+  if (conversionBits) {                                                       // Only with new data, so a running //
+    if (!bitRead(ina.operatingMode,2) && (ina.operatingMode&B011)) {          // conversion is left to finish. In //
+      writeConfiguration(ina);                                                // triggered mode start the next    //
+    } else {                                                                  // one, or else step the schedule   //
+      uint32_t period = conversionPeriod(ina.configuration);                  // of the free-running conversions  //
+      uint32_t ready  = _ReadyMicros[sample.deviceNumber]+period;             // by one period, so that delays in //
+      if ((int32_t)(micros()-ready)>=0) ready = micros()+period;              // reading don't add up, and resync //
+      _ReadyMicros[sample.deviceNumber] = ready;                              // when a period or more behind     //
+    } // of if-then-else triggered mode enabled                               //                                  //
+  } // of if-then new data                                                    //                                  //
+  return(conversionBits!=0);                                                  // Return true if the data is new   //
+} // of method readSample()                                                   //                                  //
+/*******************************************************************************************************************
+** Method readRegisters reads the 4 raw measurement registers of a device one directly after the other and stores **
+** them in the sample, without checking or changing the Conversion Ready flag.                                    **
+*******************************************************************************************************************/
+void INA226_Class::readRegisters(inaDet &ina,INA226_Sample &sample) {         // Read the 4 raw registers         //
+  sample.deviceNumber = &ina-_Devices;                                        // Store the actual device number   //
+  sample.busRaw     = readWord(INA_BUS_VOLTAGE_REGISTER,ina.address);         // Read the 4 raw register values   //
+  sample.shuntRaw   = readWord(INA_SHUNT_VOLTAGE_REGISTER,ina.address);       // one directly after the other     //
+  sample.currentRaw = readWord(INA_CURRENT_REGISTER,ina.address);             //                                  //
+  sample.powerRaw   = readWord(INA_POWER_REGISTER,ina.address);               //                                  //
+} // of method readRegisters()                                                //                                  //
+/*******************************************************************************************************************
+** Method convertSample converts the raw register values in a sample to millivolts, microvolts, microamps and     **
+** microwatts using the calibration of the device the sample came from.                                           **
+*******************************************************************************************************************/
+void INA226_Class::convertSample(const INA226_Sample &sample,                 // Convert raw sample to units      //
+                                 INA226_Reading &reading) {                   //                                  //
+  inaDet &ina = device(sample.deviceNumber);                                  // Device details from table        //
+  reading.deviceNumber    = sample.deviceNumber;                              //                                  //
+  reading.busMilliVolts   = inaBusMilliVolts(sample.busRaw);                  // Convert to milliVolts            //
+  reading.shuntMicroVolts = inaShuntMicroVolts(sample.shuntRaw);              // Convert to microvolts            //
+  reading.busMicroAmps    = microAmps(ina,sample.currentRaw);                 // Convert to microamps             //
+  reading.busMicroWatts   = inaMicroWatts(sample.powerRaw,ina.power_Mult,     // Convert to microwatts            //
+                                          ina.power_Shift);                   //                                  //
+} // of method convertSample()                                                //                                  //
+/*******************************************************************************************************************
+** Method convertSamples converts a batch of count raw samples, for example ones collected with readRawAll() or   **
+** taken from a sample buffer, so that the arithmetic can be done away from the sampling loop.                    **
+*******************************************************************************************************************/
+void INA226_Class::convertSamples(const INA226_Sample samples[],              // Convert a batch of raw samples   //
+                                  INA226_Reading readings[],                  //                                  //
+                                  const uint8_t count) {                      //                                  //
+  for(uint8_t i=0;i<count;i++) convertSample(samples[i],readings[i]);         // Convert each sample              //
+} // of method convertSamples()                                               //                                  //
+/*******************************************************************************************************************
+** The raw accessors getBusRaw(), getShuntRaw(), getCurrentRaw() and getPowerRaw() return the untouched register  **
+** value for the device. They neither wait for a conversion nor start one in triggered mode, use                  **
+** waitForConversion() and triggerAll() for that. The raw values are converted with the inaBusMilliVolts(),       **
+** inaShuntMicroVolts(), inaMicroAmps() and inaMicroWatts() helpers or with convertSample().                      **
+*******************************************************************************************************************/
+uint16_t INA226_Class::getBusRaw(const uint8_t deviceNumber) {                // Raw bus voltage register         //
+  return readWord(INA_BUS_VOLTAGE_REGISTER,device(deviceNumber).address);     //                                  //
+} // of method getBusRaw()                                                    //                                  //
+int16_t INA226_Class::getShuntRaw(const uint8_t deviceNumber) {               // Raw shunt voltage register       //
+  return readWord(INA_SHUNT_VOLTAGE_REGISTER,device(deviceNumber).address);   //                                  //
+} // of method getShuntRaw()                                                  //                                  //
+int16_t INA226_Class::getCurrentRaw(const uint8_t deviceNumber) {             // Raw current register             //
+  return readWord(INA_CURRENT_REGISTER,device(deviceNumber).address);         //                                  //
+} // of method getCurrentRaw()                                                //                                  //
+uint16_t INA226_Class::getPowerRaw(const uint8_t deviceNumber) {              // Raw power register               //
+  return readWord(INA_POWER_REGISTER,device(deviceNumber).address);           //                                  //
+} // of method getPowerRaw()                                                  //                                  //
+/*******************************************************************************************************************
+** Method readRaw is the raw version of readAll(). The 4 measurement registers of the device are read into the    **
+** sample without any conversion, which halves the storage needed compared with an INA226_Reading. The            **
+** deltaMicros field is not set. The return value is true if the values came from a conversion not previously     **
+** read.                                                                                                          **
+*******************************************************************************************************************/
+bool INA226_Class::readRaw(const uint8_t deviceNumber,INA226_Sample &sample,  // Retrieve all raw values at once  //
+                           const bool waitSwitch) {                           //                                  //
+  return readSample(deviceNumber,sample,waitSwitch);                          //                                  //
+} // of method readRaw()                                                      //                                  //
+/*******************************************************************************************************************
+** Method readRawAll is the raw batch mode. Each of the devices selected in the deviceMask bitmask, which can be  **
+** INA_ALL_DEVICES, that has a new conversion is read into the next element of the samples array, which needs     **
+** space for one sample per selected device. The number of samples stored is returned.                            **
+*******************************************************************************************************************/
+uint8_t INA226_Class::readRawAll(INA226_Sample samples[],                     // Raw registers of several devices //
+                                 const uint16_t deviceMask) {                 //                                  //
+  uint8_t samplesRead = 0;                                                    // Number of samples stored         //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
+    if (bitRead(deviceMask,i) && readSample(i,samples[samplesRead],false)) {  // If selected and conversion done  //
+      samples[samplesRead++].deltaMicros = 0;                                 // keep the sample                  //
+    } // of if-then new sample                                                //                                  //
+  } // for-next each device loop                                              //                                  //
+  return samplesRead;                                                         // Return number of samples stored  //
+} // of method readRawAll()                                                   //                                  //
+/*******************************************************************************************************************
 ** Method reset resets the INA226 using the first bit in the configuration register                               **
 *******************************************************************************************************************/
 void INA226_Class::reset(const uint8_t deviceNumber) {                        // Reset the INA226                 //
-  inaDet ina;                                                                 // Hold device details in structure //
-  int16_t configRegister;                                                     // Hold configuration register      //
   for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
     if(deviceNumber==UINT8_MAX || deviceNumber%_DeviceCount==i ) {            // If this device needs setting     //
-      EEPROM.get(i*sizeof(ina),ina);                                          // Read EEPROM values               //
-      writeWord(INA_CONFIGURATION_REGISTER,0x8000,ina.address);               // Set most significant bit         //
-      delay(I2C_DELAY);                                                       // Let the INA226 reboot            //
+      writeWord(INA_CONFIGURATION_REGISTER,0x8000,_Devices[i].address);       // Set most significant bit         //
+      _Devices[i].configuration = INA_DEFAULT_CONFIGURATION;                  // Device registers are now back to //
+      _Devices[i].maskEnable    = 0;                                          // their power-on values            //
+      _Devices[i].alertLimit    = 0;                                          //                                  //
+      _Devices[i].operatingMode = B111;                                       //                                  //
+      waitForReset(_Devices[i].address);                                      // Let the INA226 reboot            //
+      _ReadyMicros[i] = micros()+conversionPeriod(INA_DEFAULT_CONFIGURATION); // First conversion is now running  //
+      INA_LOG(INA_LOG_INFO,INA_EVENT_RESET,_Devices[i].address,               //                                  //
+              INA_DEFAULT_CONFIGURATION);                                     //                                  //
     } // of if this device needs to be set                                    //                                  //
   } // for-next each device loop                                              //                                  //
 } // of method reset                                                          //                                  //
 /*******************************************************************************************************************
-** Method getMode returns the current monitoring mode of the device selected                                      **
+** Method getMode returns the current monitoring mode of the device selected, device 0 if none is given. Each     **
+** device keeps its own mode in the device table. After sampleLowPower() this is still the mode set with          **
+** setMode(), which the next cycle uses, while the device itself is in INA_MODE_POWER_DOWN.                       **
 *******************************************************************************************************************/
 uint8_t INA226_Class::getMode(const uint8_t deviceNumber ) {                  // Return the monitoring mode       //
-  inaDet ina;                                                                 // Hold device details in structure //
-  uint8_t tempDevice = deviceNumber+1;                                        // Temporary device number storage  //
-  EEPROM.get(tempDevice*sizeof(ina),ina);                                     // Read EEPROM values               //
-  return(ina.operatingMode);                                                  // Return stored value              //
+  return(device(deviceNumber).operatingMode);                                 // Return stored value              //
 } // of method getMode()                                                      //                                  //
 /*******************************************************************************************************************
-** Method setMode allows the various mode combinations to be set. If no parameter is given the system goes back   **
-** to the default startup mode.                                                                                   **
+** Method setMode allows the various mode combinations to be set. The mode is stored per device in the device     **
+** table, if no device number is given all devices are set.                                                       **
 *******************************************************************************************************************/
 void INA226_Class::setMode(const uint8_t mode,const uint8_t deviceNumber ) {  // Set the monitoring mode          //
-  inaDet ina;                                                                 // Hold device details in structure //
-  int16_t configRegister;                                                     // Hold configuration register      //
+  uint16_t configRegister;                                                    // Hold configuration register      //
   for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
     if(deviceNumber==UINT8_MAX || deviceNumber%_DeviceCount==i ) {            // If this device needs setting     //
-      EEPROM.get(i*sizeof(ina),ina);                                          // Read EEPROM values               //
-      configRegister = readWord(INA_CONFIGURATION_REGISTER,ina.address);      // Get the current register         //
+      inaDet &ina = _Devices[i];                                              // Device details from table        //
+      configRegister = ina.configuration;                                     // Get the cached register          //
       configRegister &= ~INA_CONFIG_MODE_MASK;                                // zero out the mode bits           //
       ina.operatingMode = B00001111 & mode;                                   // Mask off unused bits             //
-      EEPROM.put((deviceNumber%_DeviceCount)*sizeof(ina),ina);                // Write new EEPROM values          //
       configRegister |= ina.operatingMode;                                    // shift in the mode settings       //
-      writeWord(INA_CONFIGURATION_REGISTER,configRegister,ina.address);       // Save new value                   //
+      ina.configuration = configRegister;                                     // Update the cached register       //
+      writeConfiguration(ina);                                                // Save new value                   //
     } // of if this device needs to be set                                    //                                  //
   } // for-next each device loop                                              //                                  //
 } // of method setMode()                                                      //                                  //
@@ -219,23 +878,16 @@ void INA226_Class::setMode(const uint8_t mode,const uint8_t deviceNumber ) {  //
 void INA226_Class::setAveraging(const uint16_t averages,                      // Set the number of averages taken //
                                 const uint8_t deviceNumber ) {                //                                  //
   uint8_t averageIndex;                                                       // Store indexed value for register //
-  int16_t configRegister;                                                     // Configuration register contents  //
-  inaDet ina;                                                                 // Hold device details in structure //
-  EEPROM.get((deviceNumber%_DeviceCount)*sizeof(ina),ina);                    // Read EEPROM values               //
+  uint16_t configRegister;                                                    // Configuration register contents  //
   for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
     if(deviceNumber==UINT8_MAX || deviceNumber%_DeviceCount==i ) {            // If this device needs setting     //
-      configRegister = readWord(INA_CONFIGURATION_REGISTER,ina.address);      // Get the current register         //
-      if      (averages>=1024) averageIndex = 7;                              // setting depending upon range     //
-      else if (averages>= 512) averageIndex = 6;                              //                                  //
-      else if (averages>= 256) averageIndex = 5;                              //                                  //
-      else if (averages>= 128) averageIndex = 4;                              //                                  //
-      else if (averages>=  64) averageIndex = 3;                              //                                  //
-      else if (averages>=  16) averageIndex = 2;                              //                                  //
-      else if (averages>=   4) averageIndex = 1;                              //                                  //
-      else                     averageIndex = 0;                              //                                  //
+      inaDet &ina = _Devices[i];                                              // Device details from table        //
+      configRegister = ina.configuration;                                     // Get the cached register          //
+      averageIndex = inaAveragingIndex(averages);                             // setting depending upon range     //
       configRegister &= ~INA_CONFIG_AVG_MASK;                                 // zero out the averages part       //
       configRegister |= (uint16_t)averageIndex << 9;                          // shift in the averages to register//
-      writeWord(INA_CONFIGURATION_REGISTER,configRegister,ina.address);       // Save new value                   //
+      ina.configuration = configRegister;                                     // Update the cached register       //
+      writeConfiguration(ina);                                                // Save new value                   //
     } // of if this device needs to be set                                    //                                  //
   } // for-next each device loop                                              //                                  //
 } // of method setAveraging()                                                 //                                  //
@@ -244,16 +896,16 @@ void INA226_Class::setAveraging(const uint16_t averages,                      //
 *******************************************************************************************************************/
 void INA226_Class::setBusConversion(uint8_t convTime,                         // Set timing for Bus conversions   //
                                     const uint8_t deviceNumber ) {            //                                  //
-  inaDet ina;                                                                 // Hold device details in structure //
-  EEPROM.get((deviceNumber%_DeviceCount)*sizeof(ina),ina);                    // Read EEPROM values               //
-  int16_t configRegister;                                                     // Store configuration register     //
+  uint16_t configRegister;                                                    // Store configuration register     //
   for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
     if(deviceNumber==UINT8_MAX || deviceNumber%_DeviceCount==i ) {            // If this device needs setting     //
+      inaDet &ina = _Devices[i];                                              // Device details from table        //
       if (convTime>7) convTime=7;                                             // Use maximum value allowed        //
-      configRegister = readWord(INA_CONFIGURATION_REGISTER,ina.address);      // Get the current register         //
+      configRegister = ina.configuration;                                     // Get the cached register          //
       configRegister &= ~INA_CONFIG_BUS_TIME_MASK;                            // zero out the Bus conversion part //
       configRegister |= (uint16_t)convTime << 6;                              // shift in the averages to register//
-      writeWord(INA_CONFIGURATION_REGISTER,configRegister,ina.address);       // Save new value                   //
+      ina.configuration = configRegister;                                     // Update the cached register       //
+      writeConfiguration(ina);                                                // Save new value                   //
     } // of if this device needs to be set                                    //                                  //
   } // for-next each device loop                                              //                                  //
 } // of method setBusConversion()                                             //                                  //
@@ -262,51 +914,1447 @@ void INA226_Class::setBusConversion(uint8_t convTime,                         //
 *******************************************************************************************************************/
 void INA226_Class::setShuntConversion(uint8_t convTime,                       // Set timing for Bus conversions   //
                                       const uint8_t deviceNumber ) {          //                                  //
-  inaDet ina;                                                                 // Hold device details in structure //
-  EEPROM.get((deviceNumber%_DeviceCount)*sizeof(ina),ina);                    // Read EEPROM values               //
-  int16_t configRegister;                                                     // Store configuration register     //
+  uint16_t configRegister;                                                    // Store configuration register     //
   for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
     if(deviceNumber==UINT8_MAX || deviceNumber%_DeviceCount==i ) {            // If this device needs setting     //
+      inaDet &ina = _Devices[i];                                              // Device details from table        //
       if (convTime>7) convTime=7;                                             // Use maximum value allowed        //
-      configRegister = readWord(INA_CONFIGURATION_REGISTER,ina.address);      // Get the current register         //
+      configRegister = ina.configuration;                                     // Get the cached register          //
       configRegister &= ~INA_CONFIG_SHUNT_TIME_MASK;                          // zero out the Bus conversion part //
       configRegister |= (uint16_t)convTime << 3;                              // shift in the averages to register//
-      writeWord(INA_CONFIGURATION_REGISTER,configRegister,ina.address);       // Save new value                   //
+      ina.configuration = configRegister;                                     // Update the cached register       //
+      writeConfiguration(ina);                                                // Save new value                   //
     } // of if this device needs to be set                                    //                                  //
   } // for-next each device loop                                              //                                  //
 } // of method setShuntConversion()                                           //                                  //
 /*******************************************************************************************************************
+** Method configure applies the configuration changes collected in config to all of the devices selected in the   **
+** deviceMask bitmask, which can be INA_ALL_DEVICES. The new configuration register of each device is computed    **
+** from its cached one and written once, so changing the averaging, both conversion times and the mode takes one  **
+** write per device instead of one for each setting. Devices whose register doesn't change are not written at     **
+** all, which also means that their running conversion isn't restarted. A mode change is stored as the operating  **
+** mode of the device, as setMode() does. The returned bitmask shows which devices were written.                  **
+*******************************************************************************************************************/
+uint16_t INA226_Class::configure(const INA226_Config &config,                 // Apply configuration changes with //
+                                 const uint16_t deviceMask) {                 // one write per changed device     //
+  uint16_t written = 0;                                                       // Bitmask of devices written       //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
+    if (!bitRead(deviceMask,i)) continue;                                     // Skip devices not selected        //
+    inaDet  &ina            = _Devices[i];                                    // Device details from table        //
+    uint16_t configRegister = config.apply(ina.configuration);                // New register value               //
+    if (config.hasMode())                                                     // Keep the mode as setMode() does  //
+      ina.operatingMode = configRegister&INA_CONFIG_MODE_MASK;                //                                  //
+    if (configRegister==ina.configuration) continue;                          // Unchanged, nothing to write      //
+    ina.configuration = configRegister;                                       // Update the cached register       //
+    writeConfiguration(ina);                                                  // and write it once                //
+    written |= (uint16_t)1<<i;                                                //                                  //
+  } // for-next each device loop                                              //                                  //
+  return written;                                                             // Return bitmask of devices written//
+} // of method configure()                                                    //                                  //
+/*******************************************************************************************************************
+** Method getAveraging returns the number of averages the device is set to take, from the cached configuration   **
+** register in the device table.                                                                                  **
+*******************************************************************************************************************/
+uint16_t INA226_Class::getAveraging(const uint8_t deviceNumber) {             // Get the number of averages taken //
+  uint8_t averageIndex = (device(deviceNumber).configuration&                 // Averaging index from register    //
+                          INA_CONFIG_AVG_MASK)>>9;                            //                                  //
+  if (averageIndex<4) return 1<<(2*averageIndex);                             // 1, 4, 16 or 64 averages          //
+  return 1<<(averageIndex+3);                                                 // 128 to 1024 averages             //
+} // of method getAveraging()                                                 //                                  //
+/*******************************************************************************************************************
+** Method getBusConversion returns the bus conversion time setting (0-7, see the datasheet) of the device, from   **
+** the cached configuration register in the device table.                                                         **
+*******************************************************************************************************************/
+uint8_t INA226_Class::getBusConversion(const uint8_t deviceNumber) {          // Get timing for Bus conversions   //
+  return (device(deviceNumber).configuration&INA_CONFIG_BUS_TIME_MASK)>>6;    // Bus time index from register     //
+} // of method getBusConversion()                                             //                                  //
+/*******************************************************************************************************************
+** Method getShuntConversion returns the shunt conversion time setting (0-7, see the datasheet) of the device,    **
+** from the cached configuration register in the device table.                                                    **
+*******************************************************************************************************************/
+uint8_t INA226_Class::getShuntConversion(const uint8_t deviceNumber) {        // Get timing for Shunt conversions //
+  return (device(deviceNumber).configuration&INA_CONFIG_SHUNT_TIME_MASK)>>3;  // Shunt time index from register   //
+} // of method getShuntConversion()                                           //                                  //
+/*******************************************************************************************************************
 ** Method waitForConversion loops until the current conversion is marked as finished. If the conversion has       **
 ** completed already then the flag (and interrupt pin, if activated) is also reset.                               **
 *******************************************************************************************************************/
 void INA226_Class::waitForConversion(const uint8_t deviceNumber) {            // Wait for current conversion      //
   uint16_t conversionBits = 0;                                                //                                  //
-  inaDet ina;                                                                 // Hold device details in structure //
-  EEPROM.get((deviceNumber%_DeviceCount)*sizeof(ina),ina);                    // Read EEPROM values               //
   for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
     if(deviceNumber==UINT8_MAX || deviceNumber%_DeviceCount==i ) {            // If this device needs setting     //
+      inaDet &ina = _Devices[i];                                              // Device details from table        //
+      INA_INSTRUMENT(uint32_t startMicros = micros());                        // Time the wait                    //
       conversionBits = 0;                                                     //                                  //
       while(conversionBits==0) {                                              //                                  //
         conversionBits = readWord(INA_MASK_ENABLE_REGISTER,ina.address)       //                                  //
-                         &(uint16_t)8;                                        //                                  //
+                         &INA_CONVERSION_READY_MASK;                          //                                  //
       } // of while the conversion hasn't finished                            //                                  //
+      INA_INSTRUMENT(_Counters[ina.address&INA_POINTER_INDEX_MASK].waitMicros //                                  //
+                     += micros()-startMicros);                                //                                  //
     } // of if this device needs to be set                                    //                                  //
   } // for-next each device loop                                              //                                  //
 } // of method waitForConversion()                                            //                                  //
 /*******************************************************************************************************************
+** Method waitForConversion with a timeout waits for the devices selected in the deviceMask bitmask, which can be **
+** INA_ALL_DEVICES, to finish their conversions. Instead of waiting for one device after the other the devices    **
+** still pending are polled round-robin until they are all ready or the timeoutMicros has passed. The time each   **
+** device took is stored and can be retrieved with getConversionMicros(), it is UINT32_MAX for devices that timed **
+** out. The returned bitmask shows which of the devices are ready. As with the other version of the call the      **
+** conversion ready flag (and interrupt pin, if activated) is reset for the devices that are ready.               **
+*******************************************************************************************************************/
+uint16_t INA226_Class::waitForConversion(const uint32_t timeoutMicros,        // Wait with timeout, return bitmask//
+                                         const uint16_t deviceMask) {         // of devices that are ready        //
+  uint16_t readyDevices   = 0;                                                // Bitmask of ready devices         //
+  uint16_t pendingDevices = deviceMask;                                       // Bitmask of devices to wait for   //
+  uint32_t startMicros    = micros();                                         // Start time of the wait           //
+  uint32_t elapsedMicros  = 0;                                                // Time waited so far               //
+  if (_DeviceCount<16) pendingDevices &= ((uint16_t)1<<_DeviceCount)-1;       // Ignore devices that don't exist  //
+  while (pendingDevices) {                                                    // Loop until all are ready         //
+    for(uint8_t i=0;i<_DeviceCount;i++) {                                     // Loop for each device found       //
+      if (bitRead(pendingDevices,i) &&                                        // If still waiting for the device  //
+          readWord(INA_MASK_ENABLE_REGISTER,_Devices[i].address)              // and it has finished now          //
+          &INA_CONVERSION_READY_MASK) {                                       //                                  //
+        _ConversionMicros[i]  = micros()-startMicros;                         // Store the time taken             //
+        INA_INSTRUMENT(_Counters[_Devices[i].address&INA_POINTER_INDEX_MASK]. //                                  //
+                       waitMicros += _ConversionMicros[i]);                   //                                  //
+        _ReadyMicros[i]       = micros()+                                     // Next conversion one period later //
+                                conversionPeriod(_Devices[i].configuration);  //                                  //
+        readyDevices         |=  (uint16_t)1<<i;                              // Mark device as ready             //
+        pendingDevices       &= ~((uint16_t)1<<i);                            //                                  //
+      } // of if-then device has finished                                     //                                  //
+    } // for-next each device loop                                            //                                  //
+    elapsedMicros = micros()-startMicros;                                     //                                  //
+    if (elapsedMicros>=timeoutMicros) break;                                  // Stop when the deadline is reached//
+  } // of while devices are pending                                           //                                  //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Mark devices that timed out      //
+    if (bitRead(pendingDevices,i)) {                                          //                                  //
+      _ConversionMicros[i] = UINT32_MAX;                                      //                                  //
+      INA_INSTRUMENT(_Counters[_Devices[i].address&INA_POINTER_INDEX_MASK].   //                                  //
+                     waitMicros += elapsedMicros);                            //                                  //
+      INA_LOG(INA_LOG_WARNING,INA_EVENT_TIMEOUT,_Devices[i].address,          //                                  //
+              elapsedMicros);                                                 //                                  //
+    } // of if-then device timed out                                          //                                  //
+  } // for-next each device loop                                              //                                  //
+  return readyDevices;                                                        // Return bitmask of ready devices  //
+} // of method waitForConversion()                                            //                                  //
+/*******************************************************************************************************************
+** Method getConversionMicros returns the number of microseconds the device needed to become ready in the last    **
+** call to the timed waitForConversion(), or UINT32_MAX if it timed out.                                          **
+*******************************************************************************************************************/
+uint32_t INA226_Class::getConversionMicros(const uint8_t deviceNumber) {      // Time taken in last timed wait    //
+  return _ConversionMicros[&device(deviceNumber)-_Devices];                   // Return stored value              //
+} // of method getConversionMicros()                                          //                                  //
+/*******************************************************************************************************************
+** Method writeConfiguration writes the cached configuration register to a device. Since this starts a new        **
+** conversion, the time at which the results will be ready is also updated.                                       **
+*******************************************************************************************************************/
+void INA226_Class::writeConfiguration(inaDet &ina) {                          // Write cached configuration       //
+  writeWord(INA_CONFIGURATION_REGISTER,ina.configuration,ina.address);        // Write the register               //
+  _ReadyMicros[&ina-_Devices] = micros()+conversionPeriod(ina.configuration); // Conversion has restarted         //
+  INA_LOG(INA_LOG_DEBUG,INA_EVENT_CONFIGURATION,ina.address,                  //                                  //
+          ina.configuration);                                                 //                                  //
+} // of method writeConfiguration()                                           //                                  //
+/*******************************************************************************************************************
+** Method conversionPeriod computes the number of microseconds a complete conversion takes with the given         **
+** configuration register settings. This is the number of averages multiplied by the sum of the bus and shunt     **
+** conversion times of the channels that are active in the mode, or 0 if the device is powered down.              **
+*******************************************************************************************************************/
+uint32_t INA226_Class::conversionPeriod(const uint16_t configRegister) {      // Microseconds for one conversion  //
+  uint32_t conversionMicros = 0;                                              // Time for one bus+shunt pair      //
+  uint8_t  averageIndex     = (configRegister&INA_CONFIG_AVG_MASK)>>9;        // Averaging index from register    //
+  if (configRegister&B001) {                                                  // If the shunt is being converted  //
+    conversionMicros += pgm_read_word(&INA_CONVERSION_MICROS                  // add shunt conversion time        //
+      [(configRegister&INA_CONFIG_SHUNT_TIME_MASK)>>3]);                      //                                  //
+  } // of if-then shunt active                                                //                                  //
+  if (configRegister&B010) {                                                  // If the bus is being converted    //
+    conversionMicros += pgm_read_word(&INA_CONVERSION_MICROS                  // add bus conversion time          //
+      [(configRegister&INA_CONFIG_BUS_TIME_MASK)>>6]);                        //                                  //
+  } // of if-then bus active                                                  //                                  //
+  if (averageIndex<4) return conversionMicros<<(2*averageIndex);              // 1, 4, 16 or 64 averages          //
+  return conversionMicros<<(averageIndex+3);                                  // 128 to 1024 averages             //
+} // of method conversionPeriod()                                             //                                  //
+/*******************************************************************************************************************
+** Method getConversionPeriod returns the number of microseconds a complete conversion takes with the current     **
+** averaging, conversion time and mode settings of the device, or 0 if the device is powered down.                **
+*******************************************************************************************************************/
+uint32_t INA226_Class::getConversionPeriod(const uint8_t deviceNumber) {      // Microseconds for one conversion  //
+  return conversionPeriod(device(deviceNumber).configuration);                // Compute from cached register     //
+} // of method getConversionPeriod()                                          //                                  //
+/*******************************************************************************************************************
+** Method nextReadyMicros returns the micros() value at which the next conversion of the device is expected to be **
+** finished. This is worked out from the conversion period whenever a conversion is started or a finished one is  **
+** read. If called with the default UINT8_MAX the earliest time of all converting devices is returned, or a time  **
+** INT32_MAX microseconds in the future if none are converting.                                                   **
+*******************************************************************************************************************/
+uint32_t INA226_Class::nextReadyMicros(const uint8_t deviceNumber) {          // When next results are expected   //
+  if (deviceNumber!=UINT8_MAX) {                                              // Return value for one device      //
+    return _ReadyMicros[&device(deviceNumber)-_Devices];                      //                                  //
+  } // of if-then single device                                               //                                  //
+  uint32_t nowMicros   = micros();                                            // Current time                     //
+  int32_t  waitMicros  = INT32_MAX;                                           // Shortest wait found              //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
+    if (conversionPeriod(_Devices[i].configuration) &&                        // If converting, and earlier than  //
+        (int32_t)(_ReadyMicros[i]-nowMicros)<waitMicros) {                    // all others so far, use it        //
+      waitMicros = _ReadyMicros[i]-nowMicros;                                 //                                  //
+    } // of if-then earlier device                                            //                                  //
+  } // for-next each device loop                                              //                                  //
+  return nowMicros+waitMicros;                                                // Return the earliest time         //
+} // of method nextReadyMicros()                                              //                                  //
+/*******************************************************************************************************************
+** Method serviceSchedule reads the devices selected in the deviceMask bitmask whose conversions are due and      **
+** stores the new samples in the buffer, without polling devices whose data cannot be ready yet. It is a polled   **
+** alternative to the ALERT pin driven service(). If a device is found not to be ready yet, since its internal    **
+** clock isn't exact, it is checked again after 1/16th of its conversion period. A device that isn't ready is not **
+** re-triggered, so its running conversion is left to finish, and the check time is never moved before the end of **
+** a conversion that has just been started. The number of new samples stored is returned.                         **
+*******************************************************************************************************************/
+uint8_t INA226_Class::serviceSchedule(INA226_SampleBuffer &buffer,            // Read devices whose data is due   //
+                                      const uint16_t deviceMask) {            //                                  //
+  INA226_Sample sample;                                                       // Hold the values read             //
+  uint8_t  samples = 0;                                                       // Number of samples stored         //
+  uint32_t period;                                                            // Conversion period of device      //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
+    period = conversionPeriod(_Devices[i].configuration);                     //                                  //
+    if (!bitRead(deviceMask,i) || period==0 ||                                // Skip if not selected, powered    //
+        (int32_t)(micros()-_ReadyMicros[i])<0) continue;                      // down or not due yet              //
+    if (readSample(i,sample,false)) {                                         // If the conversion is done,       //
+      if (store(buffer,sample,micros())) samples++;                           // store the sample                 //
+    } else if ((int32_t)(micros()-_ReadyMicros[i])>=0) {                      // otherwise check again soon, but  //
+      _ReadyMicros[i] = micros()+(period>>4)+1;                               // not before a restarted one       //
+    } // of if-then-else new sample                                           //                                  //
+  } // for-next each device loop                                              //                                  //
+  return samples;                                                             // Return number of samples stored  //
+} // of method serviceSchedule()                                              //                                  //
+/*******************************************************************************************************************
+** Method triggerAll starts a new conversion on all of the devices selected in the deviceMask bitmask, which can  **
+** be INA_ALL_DEVICES, by writing their configuration registers back to back. All the selected devices then       **
+** convert at the same time instead of one after the other, and collectAll() reads the results. Devices in a      **
+** continuous mode are restarted as well so that they are in step with the others, powered down devices are       **
+** skipped. The returned bitmask shows which devices were started.                                                **
+*******************************************************************************************************************/
+uint16_t INA226_Class::triggerAll(const uint16_t deviceMask) {                // Start conversions on all devices //
+  uint16_t triggered = 0;                                                     // Bitmask of devices started       //
+  _TriggerMicros = micros();                                                  // All samples get this timestamp   //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
+    if (bitRead(deviceMask,i) &&                                              // If selected and not powered down //
+        conversionPeriod(_Devices[i].configuration)) {                        //                                  //
+      writeConfiguration(_Devices[i]);                                        // start the conversion             //
+      triggered |= (uint16_t)1<<i;                                            // and mark device as started       //
+    } // of if-then device selected                                           //                                  //
+  } // for-next each device loop                                              //                                  //
+  _TriggeredDevices = triggered;                                              // Remember for collectAll()        //
+  return triggered;                                                           // Return bitmask of started devices//
+} // of method triggerAll()                                                   //                                  //
+/*******************************************************************************************************************
+** Method collectAll waits once, using the timed waitForConversion(), for the devices started by the last         **
+** triggerAll() call and selected in the deviceMask bitmask to finish, and then reads each ready device and       **
+** stores its sample in the buffer. With the default timeoutMicros of INA_AUTO_TIMEOUT the wait is limited to     **
+** twice the longest conversion period of those devices. Unlike the other read methods no new conversion is       **
+** started afterwards, so the next cycle begins with the next call to triggerAll(). All of the samples are        **
+** timestamped with the time of the triggerAll() call, so the first one of a cycle has the time since the         **
+** previous cycle and the others have a deltaMicros of 0. The returned bitmask shows which devices were read, any **
+** missing ones timed out or were lost because the buffer was full.                                               **
+*******************************************************************************************************************/
+uint16_t INA226_Class::collectAll(INA226_SampleBuffer &buffer,                // Wait once and read all devices   //
+                                  const uint32_t timeoutMicros,               //                                  //
+                                  const uint16_t deviceMask) {                //                                  //
+  INA226_Sample sample;                                                       // Hold the values read             //
+  uint16_t collected    = 0;                                                  // Bitmask of devices stored        //
+  uint16_t pending      = deviceMask&_TriggeredDevices;                       // Devices to wait for              //
+  uint32_t waitMicros   = timeoutMicros;                                      // Timeout used for the wait        //
+  if (waitMicros==INA_AUTO_TIMEOUT) {                                         // Default to twice the longest     //
+    for(uint8_t i=0;i<_DeviceCount;i++) {                                     // conversion period, so a device   //
+      uint32_t period = conversionPeriod(_Devices[i].configuration);          // that drops off the bus can't     //
+      if (bitRead(pending,i) && 2*period>waitMicros) waitMicros = 2*period;   // hang the caller                  //
+    } // for-next each device loop                                            //                                  //
+  } // of if-then automatic timeout                                           //                                  //
+  uint16_t readyDevices = waitForConversion(waitMicros,pending);              // Wait for all at the same time    //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
+    if (bitRead(readyDevices,i)) {                                            // If the device has finished       //
+      readRegisters(_Devices[i],sample);                                      // read it and store the sample     //
+      if (store(buffer,sample,_TriggerMicros)) collected |= (uint16_t)1<<i;   //                                  //
+    } // of if-then device ready                                              //                                  //
+  } // for-next each device loop                                              //                                  //
+  _TriggeredDevices &= ~readyDevices;                                         // Don't collect the devices twice  //
+  return collected;                                                           // Return bitmask of devices stored //
+} // of method collectAll()                                                   //                                  //
+/*******************************************************************************************************************
+** Method sampleLowPower does one complete low-power sampling cycle for the devices selected in the deviceMask    **
+** bitmask, and is meant to be called periodically by battery-powered sketches which keep the devices in          **
+** INA_MODE_POWER_DOWN in between. Each device with a bus and/or shunt mode set with setMode() is started in the  **
+** triggered version of that mode. If an alertPin is given the ALERT output is enabled on conversion ready and    **
+** the MCU sleeps, using INA_SLEEP_MODE on AVR processors, until ALERT fires or the conversion time from the      **
+** configuration plus 1/8 for the tolerance of the INA226 clock and INA_WAKE_MICROS for waking up has passed.     **
+** Without a pin, or if the conversion is too short to be worth sleeping for, the Conversion Ready flags are      **
+** polled instead. The results are then read into the buffer as with collectAll(), with the time of the trigger,  **
+** and the devices are put back into INA_MODE_POWER_DOWN, where they draw less than 2.5uA instead of the 330uA of **
+** continuous conversions. The returned bitmask shows which devices were read. The method can't be combined with  **
+** startSampling(), and returns 0 while that is running. Only the cached configuration register is left in power- **
+** down, the operatingMode in the device table keeps the mode from setMode() for the next cycle and is what       **
+** getMode() returns. Setters such as setAveraging() or setBusConversion() write the cached configuration and so  **
+** leave the device powered down, and a setMode() call is needed to go back to continuous conversions.            **
+*******************************************************************************************************************/
+uint16_t INA226_Class::sampleLowPower(INA226_SampleBuffer &buffer,            // Trigger, sleep until ALERT, read //
+                                      const uint8_t alertPin,                 // and power down again             //
+                                      const uint16_t deviceMask) {            //                                  //
+  uint16_t triggered    = 0;                                                  // Bitmask of devices started       //
+  uint32_t periodMicros = 0;                                                  // Longest conversion time          //
+  if (_AlertPin!=UINT8_MAX) return 0;                                         // Pin belongs to startSampling()   //
+  _TriggerMicros = micros();                                                  // All samples get this timestamp   //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
+    inaDet &ina  = _Devices[i];                                               // Device details from table        //
+    uint8_t mode = ina.operatingMode&INA_MODE_TRIGGERED_BOTH;                 // Triggered version of the mode    //
+    if (!bitRead(deviceMask,i) || mode==0) continue;                          // Skip unselected and powered down //
+    if (alertPin!=UINT8_MAX && !(ina.maskEnable&INA_CONVERSION_ALERT_ENABLE)) // Turn on the conversion ALERT once//
+      setAlertPinOnConversion(true,i);                                        //                                  //
+    ina.configuration = (ina.configuration&~INA_CONFIG_MODE_MASK)|mode;       //                                  //
+    writeConfiguration(ina);                                                  // Start the conversion             //
+    if (conversionPeriod(ina.configuration)>periodMicros)                     // and keep the longest time        //
+      periodMicros = conversionPeriod(ina.configuration);                     //                                  //
+    triggered |= (uint16_t)1<<i;                                              //                                  //
+  } // for-next each device loop                                              //                                  //
+  if (triggered==0) return 0;                                                 // Nothing was started              //
+  uint32_t timeoutMicros = periodMicros+periodMicros/8+INA_WAKE_MICROS;       // Allow for clock and wake-up      //
+  if (alertPin!=UINT8_MAX && periodMicros>INA_WAKE_MICROS) {                  // Sleep if it is worth it          //
+    _AlertFlag        = false;                                                //                                  //
+    _SamplingInstance = this;                                                 // Let alertISR() set the flag      //
+    pinMode(alertPin,INPUT_PULLUP);                                           // ALERT is an open-drain output    //
+    attachInterrupt(digitalPinToInterrupt(alertPin),alertISR,FALLING);        //                                  //
+    sleepUntilAlert(timeoutMicros);                                           //                                  //
+    detachInterrupt(digitalPinToInterrupt(alertPin));                         //                                  //
+    _SamplingInstance = NULL;                                                 //                                  //
+    _AlertFlag        = false;                                                //                                  //
+  } // of if-then sleep                                                       //                                  //
+  _TriggeredDevices = triggered;                                              // Read them with collectAll(),     //
+  uint16_t collected = collectAll(buffer,timeoutMicros,triggered);            // which also catches the devices   //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // that finish after the first one  //
+    if (bitRead(triggered,i)) {                                               // Power down all started devices,  //
+      inaDet &ina = _Devices[i];                                              // including those that timed out   //
+      ina.configuration = (ina.configuration&~INA_CONFIG_MODE_MASK)|          //                                  //
+                          INA_MODE_POWER_DOWN;                                //                                  //
+      writeConfiguration(ina);                                                //                                  //
+    } // of if-then device started                                            //                                  //
+  } // for-next each device loop                                              //                                  //
+  _TriggeredDevices = 0;                                                      //                                  //
+  return collected;                                                           // Return bitmask of devices read   //
+} // of method sampleLowPower()                                               //                                  //
+/*******************************************************************************************************************
+** Method sleepUntilAlert puts the MCU to sleep until alertISR() has set the alert flag or timeoutMicros have     **
+** passed. On AVR processors the INA_SLEEP_MODE is used, by default SLEEP_MODE_IDLE since that keeps the timer    **
+** running for micros() and can be woken by an edge on the pin; the timer interrupt wakes it regularly to check   **
+** the timeout. The flag is checked with interrupts disabled and sleep_cpu() follows sei directly, so an ALERT    **
+** which comes in between can't be missed. Other processors wait for the flag without doing any I2C traffic.      **
+*******************************************************************************************************************/
+void INA226_Class::sleepUntilAlert(const uint32_t timeoutMicros) {            // Sleep until ALERT or the timeout //
+  uint32_t startMicros = micros();                                            // Start time of the wait           //
+  #if defined(__AVR__)                                                        //                                  //
+    set_sleep_mode(INA_SLEEP_MODE);                                           //                                  //
+  #endif                                                                      //                                  //
+  while (!_AlertFlag && micros()-startMicros<timeoutMicros) {                 // Until ALERT or the deadline      //
+    #if defined(__AVR__)                                                      //                                  //
+      noInterrupts();                                                         // Check the flag once more with    //
+      if (!_AlertFlag) {                                                      // interrupts off, then sleep       //
+        sleep_enable();                                                       //                                  //
+        interrupts();                                                         // The instruction after sei is     //
+        sleep_cpu();                                                          // executed before any interrupt    //
+        sleep_disable();                                                      //                                  //
+      } // of if-then no alert yet                                            //                                  //
+      interrupts();                                                           //                                  //
+    #endif                                                                    //                                  //
+  } // of while not woken up                                                  //                                  //
+} // of method sleepUntilAlert()                                              //                                  //
+/*******************************************************************************************************************
 ** Method setAlertPinOnConversion configure the INA226 to pull the ALERT pin low when a conversion is complete    **
 *******************************************************************************************************************/
 void INA226_Class::setAlertPinOnConversion(const bool alertState,             // Enable pin change on conversion  //
                                            const uint8_t deviceNumber ) {     //                                  //
-  inaDet ina;                                                                 // Hold device details in structure //
-  EEPROM.get((deviceNumber%_DeviceCount)*sizeof(ina),ina);                    // Read EEPROM values               //
   uint16_t alertRegister;                                                     // Hold the alert register          //
   for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
     if(deviceNumber==UINT8_MAX || deviceNumber%_DeviceCount==i ) {            // If this device needs setting     //
-      alertRegister = readWord(INA_MASK_ENABLE_REGISTER,ina.address);         // Get the current register         //
+      inaDet &ina = _Devices[i];                                              // Device details from table        //
+      alertRegister = ina.maskEnable;                                         // Get the cached register          //
       if (!alertState) alertRegister &= ~((uint16_t)1<<10);                   // zero out the alert bit           //
                   else alertRegister |= (uint16_t)(1<<10);                    // turn on the alert bit            //
+      ina.maskEnable = alertRegister;                                         // Update the cached register       //
       writeWord(INA_MASK_ENABLE_REGISTER,alertRegister,ina.address);          // Write register back to device    //
     } // of if this device needs to be set                                    //                                  //
   } // for-next each device loop                                              //                                  //
-} // of method setAlertPinOnConversion                                        //----------------------------------//
+} // of method setAlertPinOnConversion                                        //                                  //
+/*******************************************************************************************************************
+** Method setAlertLimit sets up the limit alert function of one or all devices. The alertType is one of the       **
+** INA_ALERT constants and the limit is given in the units of its name. The limit is converted to the format of   **
+** the register it is compared with using the same LSBs as the readings, current limits via the calibration into  **
+** shunt voltage limits, and written to the Alert Limit register. Current and power limits include the gain and   **
+** offset correction of calibrateCurrent() or setCorrection(), so that the alert fires at the value               **
+** getBusMicroAmps() and getBusMicroWatts() report, and they should be set again after the correction has         **
+** changed. The device only has one limit, so setting one replaces any previous one, and INA_ALERT_NONE turns the **
+** limit alert off. The conversion ready alert of setAlertPinOnConversion() is not changed.                       **
+*******************************************************************************************************************/
+void INA226_Class::setAlertLimit(const uint8_t alertType,const int32_t limit, // Set limit alert in units         //
+                                 const uint8_t deviceNumber) {                //                                  //
+  int32_t  limitRaw;                                                          // Limit in register format         //
+  uint16_t alertBit;                                                          // Mask/enable bit of the function  //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
+    if(deviceNumber==UINT8_MAX || deviceNumber%_DeviceCount==i ) {            // If this device needs setting     //
+      inaDet &ina = _Devices[i];                                              // Device details from table        //
+      switch (alertType) {                                                    // Convert the limit                //
+        case INA_ALERT_SHUNT_OVER_UV:                                         //                                  //
+        case INA_ALERT_SHUNT_UNDER_UV:                                        //                                  //
+          limitRaw = limit*10/INA_SHUNT_VOLTAGE_LSB;                          // Shunt register is 2.5uV per LSB  //
+          alertBit = (alertType==INA_ALERT_SHUNT_OVER_UV) ? 0x8000 : 0x4000;  // Shunt over or under-voltage bit  //
+          break;                                                              //                                  //
+        case INA_ALERT_CURRENT_OVER_UA:                                       //                                  //
+        case INA_ALERT_CURRENT_UNDER_UA:                                      //                                  //
+          limitRaw = ((int64_t)limit*100000/correctedLSB(ina)+                // Current register value of the    //
+                      ina.currentOffset)*2048/correctedCalibration(ina);      // corrected reading, which is the  //
+          alertBit = (alertType==INA_ALERT_CURRENT_OVER_UA) ? 0x8000 : 0x4000;// shunt * calibration / 2048      //
+          break;                                                              //                                  //
+        case INA_ALERT_BUS_OVER_MV:                                           //                                  //
+        case INA_ALERT_BUS_UNDER_MV:                                          //                                  //
+          limitRaw = limit*100/INA_BUS_VOLTAGE_LSB;                           // Bus register is 1.25mV per LSB   //
+          if (limitRaw<0) limitRaw = 0;                                       // and never negative               //
+          alertBit = (alertType==INA_ALERT_BUS_OVER_MV) ? 0x2000 : 0x1000;    // Bus over or under-voltage bit    //
+          break;                                                              //                                  //
+        case INA_ALERT_POWER_OVER_UW:                                         //                                  //
+          limitRaw = (int64_t)limit*1000/(25*correctedLSB(ina));              // Power register is 25*current_LSB //
+          if (limitRaw<0) limitRaw = 0;                                       // and never negative               //
+          if (limitRaw>UINT16_MAX) limitRaw = UINT16_MAX;                     //                                  //
+          alertBit = 0x0800;                                                  // Power over-limit bit             //
+          break;                                                              //                                  //
+        default:                                                              //                                  //
+          limitRaw = 0;                                                       // No limit alert                   //
+          alertBit = 0;                                                       //                                  //
+      } // of switch alertType                                                //                                  //
+      if (alertBit>=0x1000) {                                                 // Voltage registers are signed     //
+        if (limitRaw>INT16_MAX) limitRaw = INT16_MAX;                         // 16 bit values                    //
+        if (limitRaw<INT16_MIN) limitRaw = INT16_MIN;                         //                                  //
+      } // of if-then voltage limit                                           //                                  //
+      ina.alertLimit = limitRaw;                                              // Update the cached registers      //
+      ina.maskEnable = (ina.maskEnable&~INA_ALERT_FUNCTION_MASK)|alertBit;    //                                  //
+      writeWord(INA_ALERT_LIMIT_REGISTER,ina.alertLimit,ina.address);         // Write the limit before enabling  //
+      writeWord(INA_MASK_ENABLE_REGISTER,ina.maskEnable,ina.address);         // the alert function               //
+    } // of if this device needs to be set                                    //                                  //
+  } // for-next each device loop                                              //                                  //
+} // of method setAlertLimit()                                                //                                  //
+/*******************************************************************************************************************
+** Method getAlertLimit returns the contents of the Alert Limit register of the device.                           **
+*******************************************************************************************************************/
+uint16_t INA226_Class::getAlertLimit(const uint8_t deviceNumber) {            // Read the alert limit register    //
+  return readWord(INA_ALERT_LIMIT_REGISTER,device(deviceNumber).address);     //                                  //
+} // of method getAlertLimit()                                                //                                  //
+/*******************************************************************************************************************
+** Method getAlertFlag returns true if the limit set with setAlertLimit() has been exceeded. If the alert is      **
+** latched this resets it, and as with any read of the Mask/Enable register the conversion ready flag is reset.   **
+*******************************************************************************************************************/
+bool INA226_Class::getAlertFlag(const uint8_t deviceNumber) {                 // True if the limit was exceeded   //
+  return readWord(INA_MASK_ENABLE_REGISTER,device(deviceNumber).address)      //                                  //
+         &INA_ALERT_FUNCTION_FLAG;                                            //                                  //
+} // of method getAlertFlag()                                                 //                                  //
+/*******************************************************************************************************************
+** Method startSampling starts the interrupt-driven sampling engine. The selected devices (all of them by         **
+** default) are set to pull the ALERT pin low when a conversion is complete. If an alertPin is given then an      **
+** interrupt handler is attached to it which only sets a flag, otherwise the program's own interrupt handler      **
+** needs to call alertTriggered(). The actual I2C reads are done outside of interrupt context by calling          **
+** service() from the main loop, which stores the new samples in the buffer. Only one instance can use an         **
+** attached alertPin at a time. The method returns false if the alertPin cannot be used for an interrupt.         **
+*******************************************************************************************************************/
+bool INA226_Class::startSampling(INA226_SampleBuffer &buffer,                 // Start interrupt-driven sampling  //
+                                 const uint8_t alertPin,                      //                                  //
+                                 const uint8_t deviceNumber) {                //                                  //
+  #ifdef NOT_AN_INTERRUPT                                                     // Only defined by some cores       //
+    if (alertPin!=UINT8_MAX &&                                                // Return if the pin can't be       //
+        digitalPinToInterrupt(alertPin)==NOT_AN_INTERRUPT) return false;      // used for an interrupt            //
+  #endif                                                                      //                                  //
+  stopSampling();                                                             // Detach any previous handler      //
+  _SampleBuffer    = &buffer;                                                 // Store the buffer to use          //
+  _SamplingDevices = 0;                                                       //                                  //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
+    if(deviceNumber==UINT8_MAX || deviceNumber%_DeviceCount==i ) {            // If this device needs sampling    //
+      _SamplingDevices |= (uint16_t)1<<i;                                     // Add it to the bitmask            //
+    } // of if this device needs to be sampled                                //                                  //
+  } // for-next each device loop                                              //                                  //
+  setAlertPinOnConversion(true,deviceNumber);                                 // Alert pin when conversion done   //
+  _AlertPin = alertPin;                                                       //                                  //
+  if (_AlertPin!=UINT8_MAX) {                                                 // If the pin is to be handled here //
+    _SamplingInstance = this;                                                 // then attach our handler          //
+    pinMode(_AlertPin,INPUT_PULLUP);                                          // ALERT is an open-drain output    //
+    attachInterrupt(digitalPinToInterrupt(_AlertPin),alertISR,FALLING);       //                                  //
+  } // of if-then attach ISR                                                  //                                  //
+  _AlertFlag = true;                                                          // Conversion might already be done //
+  return true;                                                                //                                  //
+} // of method startSampling()                                                //                                  //
+/*******************************************************************************************************************
+** Method startAlertCapture starts the sampling engine in capture mode, where the ALERT pin is driven by the      **
+** limit alerts set with setAlertLimit() instead of by finished conversions. Nothing is read while all the values **
+** are within their limits, and service() only reads and stores a sample from the devices whose limit was         **
+** exceeded. The alerts are latched, so the pin stays low until service() has read the device and fires again     **
+** after the next conversion if the limit is still exceeded. Captured samples go straight into the buffer,        **
+** without the statistics, filters, adaptive averaging or charge and energy totals of the other sampling paths,   **
+** since they only cover the times a limit was exceeded and would give a wrong average or integral. The method    **
+** returns false if the alertPin cannot be used for an interrupt.                                                 **
+*******************************************************************************************************************/
+bool INA226_Class::startAlertCapture(INA226_SampleBuffer &buffer,             // Capture samples only when the    //
+                                     const uint8_t alertPin,                  // limit alert fires                //
+                                     const uint8_t deviceNumber) {            //                                  //
+  if (!startSampling(buffer,alertPin,deviceNumber)) return false;             // Set up the engine                //
+  setAlertPinOnConversion(false,deviceNumber);                                // No alert on conversions          //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device sampled     //
+    if (bitRead(_SamplingDevices,i)) {                                        // and latch the limit alerts       //
+      _Devices[i].maskEnable |= INA_ALERT_LATCH_ENABLE;                       //                                  //
+      writeWord(INA_MASK_ENABLE_REGISTER,_Devices[i].maskEnable,              //                                  //
+                _Devices[i].address);                                         //                                  //
+    } // of if-then device sampled                                            //                                  //
+  } // for-next each device loop                                              //                                  //
+  _AlertCapture = true;                                                       // service() checks limit flags     //
+  return true;                                                                //                                  //
+} // of method startAlertCapture()                                            //                                  //
+/*******************************************************************************************************************
+** Method stopSampling stops the interrupt-driven sampling engine, detaching the interrupt handler if one was     **
+** attached and turning off the conversion-ready ALERT on the sampled devices.                                    **
+*******************************************************************************************************************/
+void INA226_Class::stopSampling() {                                           // Stop interrupt-driven sampling   //
+  if (_AlertPin!=UINT8_MAX) {                                                 // If ISR was attached, remove it   //
+    detachInterrupt(digitalPinToInterrupt(_AlertPin));                        //                                  //
+    if (_SamplingInstance==this) _SamplingInstance = NULL;                    //                                  //
+    _AlertPin = UINT8_MAX;                                                    //                                  //
+  } // of if-then detach ISR                                                  //                                  //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device sampled     //
+    if (bitRead(_SamplingDevices,i)) {                                        // and turn off the alert           //
+      _Devices[i].maskEnable &= ~((uint16_t)1<<10);                           //                                  //
+      if (_AlertCapture) _Devices[i].maskEnable &= ~INA_ALERT_LATCH_ENABLE;   // as well as the capture latch     //
+      writeWord(INA_MASK_ENABLE_REGISTER,_Devices[i].maskEnable,              //                                  //
+                _Devices[i].address);                                         //                                  //
+    } // of if-then device sampled                                            //                                  //
+  } // for-next each device loop                                              //                                  //
+  _SamplingDevices = 0;                                                       //                                  //
+  _SampleBuffer    = NULL;                                                    //                                  //
+  _AlertFlag       = false;                                                   //                                  //
+  _AlertCapture    = false;                                                   //                                  //
+} // of method stopSampling()                                                 //                                  //
+/*******************************************************************************************************************
+** Method alertTriggered only flags that at least one device has finished a conversion, it is safe to call from   **
+** an interrupt handler since it does no I2C traffic of its own.                                                  **
+*******************************************************************************************************************/
+void INA226_Class::alertTriggered() {                                         // Call from ALERT pin ISR          //
+  _AlertFlag = true;                                                          // Let service() do the work        //
+} // of method alertTriggered()                                               //                                  //
+/*******************************************************************************************************************
+** Method alertISR is the interrupt handler attached by startSampling(). Since attachInterrupt() needs a plain    **
+** function this is a static method which forwards to the instance that attached it.                              **
+*******************************************************************************************************************/
+void INA226_Class::alertISR() {                                               // ISR attached by startSampling()  //
+  if (_SamplingInstance!=NULL) _SamplingInstance->alertTriggered();           // Forward to the instance          //
+} // of method alertISR()                                                     //                                  //
+/*******************************************************************************************************************
+** Method service is called from the main loop. If the ALERT pin has fired since the last call then every sampled **
+** device whose conversion can be done is read with readSample(), which also clears the device's alert, and those **
+** with a new conversion are added to the sample buffer with a timestamp. Devices that are more than 1/8th of a   **
+** conversion period away from being due aren't polled, which leaves room for the tolerance of their internal     **
+** clock, so that the slower devices sharing the pin don't cost extra I2C reads. Samples are counted as dropped   **
+** if the buffer is full. Since the ALERT outputs of several devices are usually wired together, the flag is set  **
+** again if the pin is still being held low by a device that finished during the reads. The number of new samples **
+** stored is returned.                                                                                            **
+*******************************************************************************************************************/
+uint8_t INA226_Class::service() {                                             // Read devices flagged by the ISR  //
+  INA226_Sample sample;                                                       // Hold the values read             //
+  uint8_t samples = 0;                                                        // Number of samples stored         //
+  if (!_AlertFlag || _SampleBuffer==NULL) return 0;                           // Return if nothing to do          //
+  _AlertFlag = false;                                                         // Reset before reading devices     //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
+    if (!bitRead(_SamplingDevices,i)) continue;                               // Skip devices not sampled         //
+    if (_AlertCapture) {                                                      // In capture mode only read the    //
+      if (readWord(INA_MASK_ENABLE_REGISTER,_Devices[i].address)              // devices over their limit, reading//
+          &INA_ALERT_FUNCTION_FLAG) {                                         // the flag releases the latch      //
+        readRegisters(_Devices[i],sample);                                    // Stored as is, not accumulated,   //
+        if (_SampleBuffer->push(sample,micros())) samples++;                  // since the samples are sparse     //
+      } // of if-then limit exceeded                                          //                                  //
+    } else if ((int32_t)(micros()-_ReadyMicros[i]+                            // If the device can be ready, with //
+                         (conversionPeriod(_Devices[i].configuration)>>3))>=0 // 1/8th period for its clock, and  //
+               && readSample(i,sample,false)) {                               // the conversion is done           //
+      if (store(*_SampleBuffer,sample,micros())) samples++;                   // store the sample                 //
+    } // of if-then-else capture mode                                         //                                  //
+  } // for-next each device loop                                              //                                  //
+  if (_AlertPin!=UINT8_MAX && digitalRead(_AlertPin)==LOW) _AlertFlag = true; // Still low, check again next call //
+  return samples;                                                             // Return number of samples stored  //
+} // of method service()                                                      //                                  //
+/*******************************************************************************************************************
+** Method store handles a new sample read by service(), serviceSchedule() or collectAll(). The sample is added to **
+** the statistics and accumulators with accumulate(), which always see every sample, given to the adaptive        **
+** averaging controller and then passed through the device's filter if it has one. Samples without a filter and   **
+** filter output samples are pushed into the buffer. The return value is false if the sample was lost because the **
+** buffer was full, samples taken in by a filter count as stored.                                                 **
+*******************************************************************************************************************/
+bool INA226_Class::store(INA226_SampleBuffer &buffer,INA226_Sample &sample,   // Handle a new sample from engines //
+                         const uint32_t timeMicros) {                         //                                  //
+  accumulate(sample,timeMicros);                                              // Add to the accumulators          //
+  if (sample.deviceNumber<_AdaptiveCount) adapt(sample);                      // Adjust the averaging if adaptive //
+  if (sample.deviceNumber<_FilterCount &&                                     // If the device is filtered and    //
+      !_Filters[sample.deviceNumber].filter(sample)) return true;             // there's no output sample, done   //
+  if (buffer.push(sample,timeMicros)) return true;                            // Otherwise store the sample       //
+  INA_LOG(INA_LOG_WARNING,INA_EVENT_BUFFER_FULL,                              //                                  //
+          _Devices[sample.deviceNumber].address,buffer.dropped());            //                                  //
+  return false;                                                               //                                  //
+} // of method store()                                                        //                                  //
+/*******************************************************************************************************************
+** Method setAdaptive lets the controllers in the adaptive array, which needs one element for each of the devices **
+** 0 to count-1, adjust the averaging and conversion times of these devices as the samples come in. Each device   **
+** starts at its controller's minLevel so that nothing is missed while it settles. Passing a count of 0 stops the **
+** controllers and leaves the devices at their last levels.                                                       **
+*******************************************************************************************************************/
+void INA226_Class::setAdaptive(INA226_Adaptive adaptive[],                    // Adapt averaging of devices 0 to  //
+                               const uint8_t count) {                         // count-1                          //
+  _AdaptiveCount = 0;                                                         // Stop updates during the change   //
+  _Adaptive      = adaptive;                                                  //                                  //
+  for(uint8_t i=0;i<count && i<_DeviceCount;i++) {                            // Start each device at its fastest //
+    adaptive[i]._StableCount = 0;                                             // level                            //
+    setLevel(_Devices[i],adaptive[i]._MinLevel);                              //                                  //
+    adaptive[i]._Level = adaptive[i]._MinLevel;                               //                                  //
+  } // for-next each controller                                               //                                  //
+  _AdaptiveCount = (count>_DeviceCount) ? _DeviceCount : count;               //                                  //
+} // of method setAdaptive()                                                  //                                  //
+/*******************************************************************************************************************
+** Method adapt runs the adaptive averaging controller of the device for a new sample. The level is only written  **
+** to the device when it changes, and then with a single write of the cached configuration register.              **
+*******************************************************************************************************************/
+void INA226_Class::adapt(const INA226_Sample &sample) {                       // Run the averaging controller     //
+  INA226_Adaptive &ctl = _Adaptive[sample.deviceNumber];                      // Controller of the device         //
+  int32_t  delta = (int32_t)sample.currentRaw-ctl._LastCurrent;               // Change in current since the last //
+  uint32_t change = (delta<0) ? -delta : delta;                               // sample in LSBs                   //
+  uint8_t  level  = ctl._Level;                                               // New level, same unless changed   //
+  ctl._LastCurrent = sample.currentRaw;                                       //                                  //
+  if (change>=ctl._FastDelta) {                                               // If the current is changing fast  //
+    level            = ctl._MinLevel;                                         // use the fastest level at once    //
+    ctl._StableCount = 0;                                                     //                                  //
+  } else if (change<ctl._StableDelta) {                                       // If it is stable long enough, go  //
+    if (++ctl._StableCount>=ctl._StableSamples) {                             // one level slower                 //
+      ctl._StableCount = 0;                                                   //                                  //
+      if (level<ctl._MaxLevel) level++;                                       //                                  //
+    } // of if-then stable long enough                                        //                                  //
+  } else {                                                                    // Changes in between the thresholds//
+    ctl._StableCount = 0;                                                     // keep the current level           //
+  } // of if-then-else rate of change                                         //                                  //
+  if (level!=ctl._Level) {                                                    // Only write if the level changed  //
+    ctl._Level = level;                                                       //                                  //
+    setLevel(_Devices[sample.deviceNumber],level);                            //                                  //
+  } // of if-then level changed                                               //                                  //
+} // of method adapt()                                                        //                                  //
+/*******************************************************************************************************************
+** Method setLevel sets the averaging index and both conversion time indexes of the device to the level, using    **
+** just one write of the cached configuration register.                                                           **
+*******************************************************************************************************************/
+void INA226_Class::setLevel(inaDet &ina,const uint8_t level) {                // Write an averaging level         //
+  uint16_t configRegister = ina.configuration;                                // Get the cached register          //
+  configRegister &= ~(INA_CONFIG_AVG_MASK|INA_CONFIG_BUS_TIME_MASK|           // zero out averages and both       //
+                      INA_CONFIG_SHUNT_TIME_MASK);                            // conversion times                 //
+  configRegister |= (uint16_t)level<<9 | (uint16_t)level<<6 |                 // and shift in the new level       //
+                    (uint16_t)level<<3;                                       //                                  //
+  if (configRegister==ina.configuration) return;                              // Nothing to do if unchanged       //
+  ina.configuration = configRegister;                                         // Update the cached register       //
+  writeConfiguration(ina);                                                    // Save new value                   //
+} // of method setLevel()                                                     //                                  //
+/*******************************************************************************************************************
+** The INA226_Adaptive constructor stores the thresholds and levels of the controller, see the class declaration. **
+*******************************************************************************************************************/
+INA226_Adaptive::INA226_Adaptive(const uint16_t fastDelta,                    // Class constructor                //
+                                 const uint16_t stableDelta,                  //                                  //
+                                 const uint8_t stableSamples,                 //                                  //
+                                 const uint8_t minLevel,                      //                                  //
+                                 const uint8_t maxLevel) :                    //                                  //
+  _FastDelta(fastDelta), _StableDelta(stableDelta),                           //                                  //
+  _StableSamples(stableSamples), _MinLevel(minLevel>7 ? 7 : minLevel),        //                                  //
+  _MaxLevel(maxLevel>7 ? 7 : maxLevel<minLevel ? minLevel : maxLevel),        //                                  //
+  _Level(_MinLevel) {}                                                        //                                  //
+/*******************************************************************************************************************
+** Method level returns the level the controller is currently using.                                              **
+*******************************************************************************************************************/
+uint8_t INA226_Adaptive::level() {                                            // Level currently in use           //
+  return _Level;                                                              //                                  //
+} // of method level()                                                        //                                  //
+/*******************************************************************************************************************
+** Method setFilter passes the samples of the devices 0 to count-1 through the filters in the filters array,      **
+** which needs one element for each of these devices, before they are stored. Each filter has its own ratio and   **
+** smoothing. Passing a count of 0 stops the filtering.                                                           **
+*******************************************************************************************************************/
+void INA226_Class::setFilter(INA226_Filter filters[],const uint8_t count) {   // Filter devices 0 to count-1      //
+  _FilterCount = 0;                                                           // Stop filtering during the change //
+  _Filters     = filters;                                                     //                                  //
+  for(uint8_t i=0;i<count;i++) filters[i].clear();                            // Start with empty filters         //
+  _FilterCount = (count>_DeviceCount) ? _DeviceCount : count;                 //                                  //
+} // of method setFilter()                                                    //                                  //
+/*******************************************************************************************************************
+** The INA226_Filter constructor sets the decimation ratio and smoothing, the default values pass all samples     **
+** through unchanged.                                                                                             **
+*******************************************************************************************************************/
+INA226_Filter::INA226_Filter(const uint16_t ratio,const uint8_t smoothing) {  // Class constructor                //
+  setDecimation(ratio);                                                       //                                  //
+  setSmoothing(smoothing);                                                    //                                  //
+} // of constructor                                                           //                                  //
+/*******************************************************************************************************************
+** Method setDecimation sets the number of raw samples averaged into each output sample, from 1 (no decimation)   **
+** to INA_FILTER_MAX_RATIO, and restarts the filter.                                                              **
+*******************************************************************************************************************/
+void INA226_Filter::setDecimation(const uint16_t ratio) {                     // Samples per output sample        //
+  _Ratio = (ratio==0) ? 1 : (ratio>INA_FILTER_MAX_RATIO) ?                    // Keep ratio in range so the sums  //
+           INA_FILTER_MAX_RATIO : ratio;                                      // can't overflow                   //
+  clear();                                                                    //                                  //
+} // of method setDecimation()                                                //                                  //
+/*******************************************************************************************************************
+** Method setSmoothing sets the factor of the moving average applied to the decimated samples to 1/2^smoothing,   **
+** so that larger values smooth more and 0 turns it off. The filter is restarted.                                 **
+*******************************************************************************************************************/
+void INA226_Filter::setSmoothing(const uint8_t smoothing) {                   // Moving average factor 1/2^n      //
+  _Smoothing = (smoothing>15) ? 15 : smoothing;                               //                                  //
+  clear();                                                                    //                                  //
+} // of method setSmoothing()                                                 //                                  //
+/*******************************************************************************************************************
+** Method filter takes in one raw sample. It returns false while the current block is incomplete, and when the    **
+** block is complete it replaces the raw values in the sample with the filtered ones and returns true. Only       **
+** additions are done for the input samples, the division and moving average are worked out once per output.      **
+*******************************************************************************************************************/
+bool INA226_Filter::filter(INA226_Sample &sample) {                           // True if sample is now an output  //
+  int32_t value;                                                              // Filtered value of a channel      //
+  _Sum[0] += sample.busRaw;                                                   // Add up the block                 //
+  _Sum[1] += sample.shuntRaw;                                                 //                                  //
+  _Sum[2] += sample.currentRaw;                                               //                                  //
+  _Sum[3] += sample.powerRaw;                                                 //                                  //
+  if (++_Count<_Ratio) return false;                                          // Return until block is complete   //
+  for(uint8_t i=0;i<4;i++) {                                                  // For each channel                 //
+    value = (_Ratio==1) ? _Sum[i] :                                           // Rounded average of the block     //
+            (_Sum[i]+(_Sum[i]<0 ? -(int32_t)(_Ratio/2) : (int32_t)(_Ratio/2)))//                                  //
+            /(int32_t)_Ratio;                                                 //                                  //
+    if (_Smoothing) {                                                         // If the moving average is used,   //
+      int32_t half = (int32_t)1<<(_Smoothing-1);                              // The average is kept with         //
+      if (!_Started) _Average[i] = value*(half*2);                            // smoothing fraction bits, so no   //
+      _Average[i] += value-((_Average[i]+half)>>_Smoothing);                  // step is lost to the shift and it //
+      value        = (_Average[i]+half)>>_Smoothing;                          // settles on the input exactly     //
+    } // of if-then moving average                                            //                                  //
+    _Sum[i] = value;                                                          // Keep the output value            //
+  } // for-next each channel                                                  //                                  //
+  sample.busRaw     = _Sum[0];                                                // Replace the raw values with the  //
+  sample.shuntRaw   = _Sum[1];                                                // filtered ones                    //
+  sample.currentRaw = _Sum[2];                                                //                                  //
+  sample.powerRaw   = _Sum[3];                                                //                                  //
+  _Started = true;                                                            //                                  //
+  _Count   = 0;                                                               // Start the next block             //
+  for(uint8_t i=0;i<4;i++) _Sum[i] = 0;                                       //                                  //
+  return true;                                                                //                                  //
+} // of method filter()                                                       //                                  //
+/*******************************************************************************************************************
+** Method clear discards the current block and the moving average.                                                **
+*******************************************************************************************************************/
+void INA226_Filter::clear() {                                                 // Restart the filter               //
+  for(uint8_t i=0;i<4;i++) _Sum[i] = 0;                                       //                                  //
+  _Count   = 0;                                                               //                                  //
+  _Started = false;                                                           //                                  //
+} // of method clear()                                                        //                                  //
+/*******************************************************************************************************************
+** Method accumulate adds a new sample to the statistics of its device, if any, and to its charge and energy      **
+** totals. The current and power are multiplied by the time since the previous sample of the device, or by the    **
+** conversion period for the first sample after resetEnergy(), so that each conversion is counted once for the    **
+** time it actually covers and samples that weren't read in time don't lose any charge. The totals are kept in    **
+** uA*us and uW*us, 64 bits hold over 2500Ah or 2500Wh at full resolution. It is called by service(),             **
+** serviceSchedule() and collectAll() for every new sample, the totals are not kept if INA_NO_ENERGY is defined.  **
+*******************************************************************************************************************/
+void INA226_Class::accumulate(const INA226_Sample &sample,                    // Add sample to the accumulators   //
+                              const uint32_t timeMicros) {                    //                                  //
+  if (sample.deviceNumber<_StatisticsCount) {                                 // Update the statistics if they    //
+    _Statistics[sample.deviceNumber].add(sample);                             // are kept for the device          //
+  } // of if-then statistics kept                                             //                                  //
+  #ifndef INA_NO_ENERGY                                                       // Unless accumulators compiled out //
+    uint8_t  n           = sample.deviceNumber;                               // Device the sample came from      //
+    inaDet  &ina         = _Devices[n];                                       // Device details from table        //
+    uint32_t deltaMicros = bitRead(_EnergyStarted,n) ?                        // Time covered by this sample      //
+                           timeMicros-_EnergyMicros[n] :                      //                                  //
+                           conversionPeriod(ina.configuration);               //                                  //
+    _Charge[n] += (int64_t)microAmps(ina,sample.currentRaw)*deltaMicros;      // Add current and power multiplied //
+    _Energy[n] += (int64_t)inaMicroWatts(sample.powerRaw,ina.power_Mult,      // by the time                      //
+                                         ina.power_Shift)*deltaMicros;        //                                  //
+    _EnergyMicros[n]  = timeMicros;                                           // Remember time of the sample      //
+    _EnergyStarted   |= (uint16_t)1<<n;                                       //                                  //
+  #else                                                                       //                                  //
+    (void)timeMicros;                                                         // Only needed for the energy       //
+  #endif                                                                      //                                  //
+} // of method accumulate()                                                   //                                  //
+#ifndef INA_NO_ENERGY                                                         // Unless accumulators compiled out //
+/*******************************************************************************************************************
+** Methods getChargeMicroCoulombs and getEnergyMicroJoules return the charge (uA*s) and energy (uW*s) that the    **
+** device has accumulated since the last call to resetEnergy(), and getMicroAmpHours and getMicroWattHours return **
+** the same totals in uAh and uWh. Discharging gives negative values.                                             **
+*******************************************************************************************************************/
+int64_t INA226_Class::getChargeMicroCoulombs(const uint8_t deviceNumber) {    // Charge since last resetEnergy()  //
+  return _Charge[&device(deviceNumber)-_Devices]/1000000;                     // Convert from uA*us               //
+} // of method getChargeMicroCoulombs()                                       //                                  //
+int64_t INA226_Class::getEnergyMicroJoules(const uint8_t deviceNumber) {      // Energy since last resetEnergy()  //
+  return _Energy[&device(deviceNumber)-_Devices]/1000000;                     // Convert from uW*us               //
+} // of method getEnergyMicroJoules()                                         //                                  //
+int64_t INA226_Class::getMicroAmpHours(const uint8_t deviceNumber) {          // Charge in uAh                    //
+  return _Charge[&device(deviceNumber)-_Devices]/3600000000LL;                // Convert from uA*us               //
+} // of method getMicroAmpHours()                                             //                                  //
+int64_t INA226_Class::getMicroWattHours(const uint8_t deviceNumber) {         // Energy in uWh                    //
+  return _Energy[&device(deviceNumber)-_Devices]/3600000000LL;                // Convert from uW*us               //
+} // of method getMicroWattHours()                                            //                                  //
+/*******************************************************************************************************************
+** Method resetEnergy sets the charge and energy totals of one or all devices back to zero.                       **
+*******************************************************************************************************************/
+void INA226_Class::resetEnergy(const uint8_t deviceNumber) {                  // Zero the accumulators            //
+  for(uint8_t i=0;i<_DeviceCount;i++) {                                       // Loop for each device found       //
+    if(deviceNumber==UINT8_MAX || deviceNumber%_DeviceCount==i ) {            // If this device needs resetting   //
+      _Charge[i]      = 0;                                                    //                                  //
+      _Energy[i]      = 0;                                                    //                                  //
+      _EnergyStarted &= ~((uint16_t)1<<i);                                    // Next sample uses the period      //
+    } // of if this device needs to be reset                                  //                                  //
+  } // for-next each device loop                                              //                                  //
+} // of method resetEnergy()                                                  //                                  //
+#endif                                                                        //                                  //
+#if INA_LOG_LEVEL>INA_LOG_NONE                                                // Only if logging is compiled in   //
+/*******************************************************************************************************************
+** Method setLogCallback sends each log event to the callback as it happens, NULL stops it. The callback is       **
+** called from the library method that logs the event, so it should return quickly; it can use formatLog() to     **
+** print the event as text.                                                                                       **
+*******************************************************************************************************************/
+void INA226_Class::setLogCallback(INA226_LogCallback callback) {              // Send log events to a callback    //
+  _LogCallback = callback;                                                    //                                  //
+} // of method setLogCallback()                                               //                                  //
+/*******************************************************************************************************************
+** Method setLogBuffer stores the log events in the entries array instead, as raw values without any formatting,  **
+** so that logging costs little more than a copy. The capacity should be a power of 2 and at most 128, other      **
+** values are rounded down to the next power of 2 and the rest of the array is left unused. A capacity of 0 stops **
+** the buffer. When the buffer is full new events are dropped. Stored events are taken out with readLog() and can **
+** be printed later with formatLog(), for instance when the time critical part of the sketch is done.             **
+*******************************************************************************************************************/
+void INA226_Class::setLogBuffer(INA226_LogEntry entries[],                    // Store log events in a buffer     //
+                                const uint8_t capacity) {                     //                                  //
+  _LogMask    = 0;                                                            // Stop the buffer while it changes //
+  _LogEntries = (capacity==0) ? NULL : entries;                               //                                  //
+  _LogHead    = 0;                                                            //                                  //
+  _LogTail    = 0;                                                            //                                  //
+  uint8_t size = (capacity>128) ? 128 : capacity;                             // Round the capacity down to a     //
+  while (size&(size-1)) size &= size-1;                                       // power of 2 so that the mask uses //
+  if (_LogEntries) _LogMask = size-1;                                         // every slot it allows             //
+} // of method setLogBuffer()                                                 //                                  //
+/*******************************************************************************************************************
+** Method readLog copies the oldest stored log event into entry and removes it from the buffer. It returns false  **
+** if there is none.                                                                                              **
+*******************************************************************************************************************/
+bool INA226_Class::readLog(INA226_LogEntry &entry) {                          // Oldest stored event, if any      //
+  uint8_t tail = _LogTail;                                                    // Local copy of consumer counter   //
+  if (_LogEntries==NULL || tail==_LogHead) return false;                      // Nothing stored                   //
+  entry = _LogEntries[tail&_LogMask];                                         // Copy the event out               //
+  INA_MEMORY_BARRIER();                                                       // Event read before tail moves     //
+  _LogTail = tail+1;                                                          // Free the slot for the producer   //
+  return true;                                                                //                                  //
+} // of method readLog()                                                      //                                  //
+/*******************************************************************************************************************
+** Method formatLog prints a log event as one line of text, with the time in microseconds, the level as E, W, I   **
+** or D, the device address in hexadecimal and the event name and value, for example "1234567 D 0x40              **
+** calibration=2048". It does the formatting that logging itself leaves out, so it can be called whenever there   **
+** is time for it.                                                                                                **
+*******************************************************************************************************************/
+void INA226_Class::formatLog(const INA226_LogEntry &entry,Print &output) {    // Print an event as text           //
+  const char *name = INA_EVENT_NAMES;                                         // Start of the name list           //
+  for(uint8_t i=0;i<entry.event;i++) while(pgm_read_byte(name++));            // Skip the names of earlier events //
+  output.print(entry.micros);                                                 //                                  //
+  output.print(' ');                                                          //                                  //
+  output.print("?EWID"[entry.level<=INA_LOG_DEBUG?entry.level:0]);            // Level as a letter                //
+  output.print(F(" 0x"));                                                     //                                  //
+  output.print(entry.address,HEX);                                            //                                  //
+  output.print(' ');                                                          //                                  //
+  for(char c=pgm_read_byte(name);c;c=pgm_read_byte(++name)) output.print(c);  // Name from the PROGMEM list       //
+  output.print('=');                                                          //                                  //
+  output.println(entry.value);                                                //                                  //
+} // of method formatLog()                                                    //                                  //
+/*******************************************************************************************************************
+** Method logEvent is called through INA_LOG() for the events at or below INA_LOG_LEVEL. It timestamps the event  **
+** and passes it to the callback and to the buffer, whichever of them has been set.                               **
+*******************************************************************************************************************/
+void INA226_Class::logEvent(const uint8_t level,const uint8_t event,          // Store or send a log event        //
+                            const uint8_t address,const int32_t value) {      //                                  //
+  INA226_LogEntry entry;                                                      // Raw event, formatted later       //
+  entry.micros  = micros();                                                   //                                  //
+  entry.level   = level;                                                      //                                  //
+  entry.event   = event;                                                      //                                  //
+  entry.address = address;                                                    //                                  //
+  entry.value   = value;                                                      //                                  //
+  if (_LogCallback) _LogCallback(entry);                                      // Send it to the callback          //
+  if (_LogEntries==NULL) return;                                              // No buffer as sink                //
+  uint8_t head = _LogHead;                                                    // Local copy of producer counter   //
+  if ((uint8_t)(head-_LogTail)>_LogMask) return;                              // Drop the event if buffer is full //
+  _LogEntries[head&_LogMask] = entry;                                         //                                  //
+  INA_MEMORY_BARRIER();                                                       // Event written before head moves  //
+  _LogHead = head+1;                                                          // Make event visible to consumer   //
+} // of method logEvent()                                                     //                                  //
+#endif                                                                        //                                  //
+#ifdef INA_INSTRUMENTATION                                                    // Only if instrumentation is on    //
+/*******************************************************************************************************************
+** Method count adds an I2C transaction of the device at the address to its counters, which are kept per address  **
+** so that devices are counted while they are still being probed. A transaction which wasn't acknowledged or      **
+** returned fewer bytes than requested is counted as a NACK and its bytes are not counted.                        **
+*******************************************************************************************************************/
+void INA226_Class::count(const uint8_t deviceAddress,const uint8_t bytes,     // Count an I2C transaction         //
+                         const bool failed) {                                 //                                  //
+  INA226_Counters &counters = _Counters[deviceAddress&INA_POINTER_INDEX_MASK];// Counters of the address          //
+  counters.transactions++;                                                    //                                  //
+  if (failed) counters.nacks++;                                               // Failed transfers                 //
+  else        counters.bytes += bytes;                                        // move no counted bytes            //
+} // of method count()                                                        //                                  //
+/*******************************************************************************************************************
+** Method getCounters copies the instrumentation counters of the device, see INA226_Counters, into counters. The  **
+** copy is taken with interrupts disabled, since readRawAsync() counts from the interrupt handler of the          **
+** transport. The counters are only there if INA_INSTRUMENTATION has been defined, otherwise no instrumentation   **
+** code is compiled.                                                                                              **
+*******************************************************************************************************************/
+void INA226_Class::getCounters(const uint8_t deviceNumber,                    // Snapshot of the counters         //
+                               INA226_Counters &counters) {                   //                                  //
+  INA226_Counters &source = _Counters[device(deviceNumber).address&           // Counters of the device           //
+                                      INA_POINTER_INDEX_MASK];                //                                  //
+  noInterrupts();                                                             // Copy all values consistently     //
+  counters = source;                                                          //                                  //
+  interrupts();                                                               //                                  //
+} // of method getCounters()                                                  //                                  //
+/*******************************************************************************************************************
+** Method resetCounters zeroes the instrumentation counters of all devices.                                       **
+*******************************************************************************************************************/
+void INA226_Class::resetCounters() {                                          // Zero the counters of all devices //
+  noInterrupts();                                                             //                                  //
+  memset(_Counters,0,sizeof(_Counters));                                      //                                  //
+  interrupts();                                                               //                                  //
+} // of method resetCounters()                                                //                                  //
+#endif                                                                        //                                  //
+/*******************************************************************************************************************
+** Method setStatistics makes the sampling engines keep running statistics for the devices 0 to count-1, using    **
+** the statistics array which needs one element for each of these devices. Passing a count of 0 stops it.         **
+*******************************************************************************************************************/
+void INA226_Class::setStatistics(INA226_Statistics statistics[],              // Keep statistics for devices 0 to //
+                                 const uint8_t count) {                       // count-1                          //
+  _StatisticsCount = 0;                                                       // Stop updates during the change   //
+  _Statistics      = statistics;                                              //                                  //
+  for(uint8_t i=0;i<count;i++) statistics[i].clear();                         // Start with empty windows         //
+  _StatisticsCount = (count>_DeviceCount) ? _DeviceCount : count;             //                                  //
+} // of method setStatistics()                                                //                                  //
+/*******************************************************************************************************************
+** Method getStatistics works out the minimum, maximum, mean, standard deviation and root mean square of the bus  **
+** voltage, shunt voltage, current and power of a device over the samples added since the window was last         **
+** cleared, and converts them to the units of INA226_Reading. If clearWindow is set then a new window is started. **
+** The return value is false if no statistics are kept for the device or the window has no samples yet.           **
+*******************************************************************************************************************/
+bool INA226_Class::getStatistics(const uint8_t deviceNumber,                  // Retrieve the statistics          //
+                                 INA226_Summary &summary,                     //                                  //
+                                 const bool clearWindow) {                    //                                  //
+  uint8_t        sequence;                                                    // Sequence number of the copy      //
+  inaStatChannel channel[4];                                                  // Copy of the totals               //
+  float          scale[4];                                                    // Units per raw LSB of each channel//
+  float          mean,variance,rms;                                           // Results of one channel in raw LSB//
+  INA226_Reading *result[5] = {&summary.minimum,&summary.maximum,             // Readings to fill in              //
+                               &summary.mean,&summary.deviation,&summary.rms};//                                  //
+  inaDet &ina = device(deviceNumber);                                         // Device details from table        //
+  uint8_t n   = &ina-_Devices;                                                // Actual device number             //
+  if (n>=_StatisticsCount) return false;                                      // Return if no statistics kept     //
+  INA226_Statistics &stats = _Statistics[n];                                  //                                  //
+  do {                                                                        // Copy the totals, and do it again //
+    sequence      = stats._Sequence;                                          // if add() ran during the copy     //
+    INA_MEMORY_BARRIER();                                                     //                                  //
+    summary.count = (stats._ClearRequests!=stats._ClearsDone) ? 0 :           // A window still to be cleared has //
+                    stats._Count;                                             // no samples yet                   //
+    for(uint8_t i=0;i<4;i++) channel[i] = stats._Channel[i];                  //                                  //
+    INA_MEMORY_BARRIER();                                                     //                                  //
+  } while ((sequence&1) || sequence!=stats._Sequence);                        //                                  //
+  if (clearWindow) stats.clear();                                             // Start a new window if requested  //
+  if (summary.count==0) return false;                                         // Return if the window is empty    //
+  scale[0] = INA_BUS_VOLTAGE_LSB/100.0;                                       // mV per bus LSB                   //
+  scale[1] = INA_SHUNT_VOLTAGE_LSB/10.0;                                      // uV per shunt LSB                 //
+  scale[2] = ldexp(ina.current_Mult,-ina.current_Shift);                      // uA per current LSB               //
+  scale[3] = ldexp(ina.power_Mult,-ina.power_Shift);                          // uW per power LSB                 //
+  for(uint8_t i=0;i<4;i++) {                                                  // For each channel                 //
+    mean     = (float)channel[i].sum/summary.count;                           // Mean and variance relative to the//
+    variance = (float)channel[i].sumSquares/summary.count-mean*mean;          // first value, which doesn't change//
+    if (variance<0) variance = 0;                                             // the variance                     //
+    mean    += channel[i].first;                                              //                                  //
+    float offset = (i==2) ? ina.currentOffset : 0;                            // Offset correction of the current //
+    mean    -= offset;                                                        //                                  //
+    rms      = sqrt(variance+mean*mean);                                      //                                  //
+    float value[5] = {channel[i].minimum-offset,channel[i].maximum-offset,    //                                  //
+                      mean,sqrt(variance),rms};                               //                                  //
+    for(uint8_t j=0;j<5;j++) {                                                // Convert to units and store       //
+      int32_t units = lround(value[j]*scale[i]);                              //                                  //
+      result[j]->deviceNumber = n;                                            //                                  //
+      switch (i) {                                                            //                                  //
+        case 0:  result[j]->busMilliVolts   = units; break;                   //                                  //
+        case 1:  result[j]->shuntMicroVolts = units; break;                   //                                  //
+        case 2:  result[j]->busMicroAmps    = units; break;                   //                                  //
+        default: result[j]->busMicroWatts   = units;                          //                                  //
+      } // of switch channel                                                  //                                  //
+    } // for-next each result                                                 //                                  //
+  } // for-next each channel                                                  //                                  //
+  return true;                                                                //                                  //
+} // of method getStatistics()                                                //                                  //
+/*******************************************************************************************************************
+** Method add is called by the sampling engines to fold a new sample into the totals. A clear() requested since   **
+** the last call is done first, so the window restarts with this sample.                                          **
+*******************************************************************************************************************/
+void INA226_Statistics::add(const INA226_Sample &sample) {                    // Fold a sample into the totals    //
+  int32_t  value[4] = {sample.busRaw,sample.shuntRaw,                         // Raw values of the 4 channels     //
+                       sample.currentRaw,sample.powerRaw};                    //                                  //
+  int32_t  delta;                                                             // Value relative to the first      //
+  uint32_t magnitude;                                                         // Absolute value of the delta      //
+  uint8_t  clearRequests = _ClearRequests;                                    // Local copy of consumer counter   //
+  _Sequence = _Sequence+1;                                                    // Odd while the totals change      //
+  INA_MEMORY_BARRIER();                                                       //                                  //
+  if (clearRequests!=_ClearsDone) {                                           // Start a new window if requested  //
+    _Count      = 0;                                                          //                                  //
+    _ClearsDone = clearRequests;                                              //                                  //
+  } // of if-then clear requested                                             //                                  //
+  for(uint8_t i=0;i<4;i++) {                                                  // For each channel                 //
+    inaStatChannel &ch = _Channel[i];                                         //                                  //
+    if (_Count==0) {                                                          // The first sample of the window   //
+      ch.first      = value[i];                                               // is the reference for the sums    //
+      ch.minimum    = value[i];                                               //                                  //
+      ch.maximum    = value[i];                                               //                                  //
+      ch.sum        = 0;                                                      //                                  //
+      ch.sumSquares = 0;                                                      //                                  //
+    } else {                                                                  //                                  //
+      if (value[i]<ch.minimum) ch.minimum = value[i];                         //                                  //
+      if (value[i]>ch.maximum) ch.maximum = value[i];                         //                                  //
+      delta          = value[i]-ch.first;                                     // The delta fits into 17 bits, so  //
+      magnitude      = (delta<0) ? -delta : delta;                            // its square fits into 32 bits     //
+      ch.sum        += delta;                                                 //                                  //
+      ch.sumSquares += magnitude*magnitude;                                   //                                  //
+    } // of if-then-else first sample                                         //                                  //
+  } // for-next each channel                                                  //                                  //
+  _Count++;                                                                   //                                  //
+  INA_MEMORY_BARRIER();                                                       //                                  //
+  _Sequence = _Sequence+1;                                                    // Even again, totals consistent    //
+} // of method add()                                                          //                                  //
+/*******************************************************************************************************************
+** Method clear requests a new window. It only changes a counter, so it is safe to call while add() might be      **
+** running in an interrupt handler, and the totals are reset by the next call to add().                           **
+*******************************************************************************************************************/
+void INA226_Statistics::clear() {                                             // Start a new window               //
+  _ClearRequests = _ClearRequests+1;                                          // Request the reset                //
+} // of method clear()                                                        //                                  //
+/*******************************************************************************************************************
+** Method count returns the number of samples in the current window.                                              **
+*******************************************************************************************************************/
+uint32_t INA226_Statistics::count() {                                         // Samples in the current window    //
+  return (_ClearRequests!=_ClearsDone) ? 0 : _Count;                          //                                  //
+} // of method count()                                                        //                                  //
+/*******************************************************************************************************************
+** The INA226_Multi constructor stores the array of INA226_Class instances, one for each bus. At most             **
+** INA_MAX_BUSES buses are used.                                                                                  **
+*******************************************************************************************************************/
+INA226_Multi::INA226_Multi(INA226_Class buses[],const uint8_t busCount) :     // Class constructor                //
+  _Buses(buses),                                                              //                                  //
+  _BusCount(busCount>INA_MAX_BUSES ? INA_MAX_BUSES : busCount) {}             //                                  //
+/*******************************************************************************************************************
+** Method begin calls begin() of each of the buses, which need to have their transports set already, and numbers  **
+** the devices found. The total number of devices is returned.                                                    **
+*******************************************************************************************************************/
+uint8_t INA226_Multi::begin(const uint8_t maxBusAmps,                         // Start all buses, return devices  //
+                            const uint32_t microOhmR) {                       //                                  //
+  uint16_t devices = 0;                                                       // Devices found so far             //
+  for(uint8_t i=0;i<_BusCount;i++) {                                          // Loop for each bus                //
+    _FirstDevice[i] = devices;                                                // Its devices are numbered next    //
+    devices        += _Buses[i].begin(maxBusAmps,microOhmR);                  //                                  //
+    if (devices>UINT8_MAX) devices = UINT8_MAX;                               // Device numbers are 8 bits        //
+  } // for-next each bus                                                      //                                  //
+  _FirstDevice[_BusCount] = devices;                                          // End of the last bus              //
+  return devices;                                                             // Return number of devices found   //
+} // of method begin()                                                        //                                  //
+/*******************************************************************************************************************
+** Method deviceCount returns the number of devices on all of the buses.                                          **
+*******************************************************************************************************************/
+uint8_t INA226_Multi::deviceCount() {                                         // Devices on all buses             //
+  return _FirstDevice[_BusCount];                                             //                                  //
+} // of method deviceCount()                                                  //                                  //
+/*******************************************************************************************************************
+** Method locate returns the instance of the bus the device with the global deviceNumber is on, and sets          **
+** busDevice to its device number on that bus. NULL is returned if there is no such device.                       **
+*******************************************************************************************************************/
+INA226_Class *INA226_Multi::locate(const uint8_t deviceNumber,                // Bus instance and its device      //
+                                   uint8_t &busDevice) {                      // number for a global number       //
+  for(uint8_t i=0;i<_BusCount;i++) {                                          // Loop for each bus                //
+    if (deviceNumber<_FirstDevice[i+1]) {                                     // If the device is on this bus     //
+      busDevice = deviceNumber-_FirstDevice[i];                               // return the bus                   //
+      return &_Buses[i];                                                      //                                  //
+    } // of if-then device on this bus                                        //                                  //
+  } // for-next each bus                                                      //                                  //
+  return NULL;                                                                // Device number out of range       //
+} // of method locate()                                                       //                                  //
+/*******************************************************************************************************************
+** Method convertSample converts a sample with a global device number using the calibration of the device on its  **
+** bus, the reading gets the global device number.                                                                **
+*******************************************************************************************************************/
+void INA226_Multi::convertSample(const INA226_Sample &sample,                 // Convert raw sample to units      //
+                                 INA226_Reading &reading) {                   //                                  //
+  INA226_Sample busSample = sample;                                           // Copy with the bus device number  //
+  INA226_Class *bus = locate(sample.deviceNumber,busSample.deviceNumber);     //                                  //
+  if (bus==NULL) return;                                                      // Nothing to do if no such device  //
+  bus->convertSample(busSample,reading);                                      // Convert on the bus               //
+  reading.deviceNumber = sample.deviceNumber;                                 // and renumber                     //
+} // of method convertSample()                                                //                                  //
+/*******************************************************************************************************************
+** Method triggerAll starts a conversion on every device of every bus with triggerAll(), the number of devices    **
+** started is returned.                                                                                           **
+*******************************************************************************************************************/
+uint8_t INA226_Multi::triggerAll() {                                          // Start conversions on all buses   //
+  uint8_t started = 0;                                                        // Number of devices started        //
+  for(uint8_t i=0;i<_BusCount;i++) {                                          // Loop for each bus                //
+    for(uint16_t triggered=_Buses[i].triggerAll();triggered;triggered>>=1) {  // count the devices started        //
+      started += triggered&1;                                                 //                                  //
+    } // for-next each device started                                         //                                  //
+  } // for-next each bus                                                      //                                  //
+  return started;                                                             //                                  //
+} // of method triggerAll()                                                   //                                  //
+/*******************************************************************************************************************
+** Method readRawAll reads each device of all the buses that has a new conversion with readRawAll() into the next **
+** element of the samples array, which needs space for deviceCount() samples. The samples get global device       **
+** numbers and the number of samples stored is returned.                                                          **
+*******************************************************************************************************************/
+uint8_t INA226_Multi::readRawAll(INA226_Sample samples[]) {                   // Raw registers of all devices     //
+  uint8_t samplesRead = 0;                                                    // Number of samples stored         //
+  for(uint8_t i=0;i<_BusCount;i++) {                                          // Loop for each bus                //
+    uint8_t busSamples = _Buses[i].readRawAll(&samples[samplesRead]);         // Read the bus                     //
+    for(uint8_t j=0;j<busSamples;j++) {                                       // and renumber its samples         //
+      samples[samplesRead++].deviceNumber += _FirstDevice[i];                 //                                  //
+    } // for-next each sample                                                 //                                  //
+  } // for-next each bus                                                      //                                  //
+  return samplesRead;                                                         // Return number of samples stored  //
+} // of method readRawAll()                                                   //                                  //
+/*******************************************************************************************************************
+** Method readRawAsync starts readRawAsync() of all the devices on every bus, each bus into its own part of the   **
+** samples array, which needs space for deviceCount() samples. With asynchronous transports the buses then run    **
+** concurrently. When all the buses are done the samples are moved together, so that the samples of buses that    **
+** failed leave no gaps, and the callback is called with the samples, which have global device numbers, their     **
+** count and the first failure status, 0 if none. A bus that refuses to start counts as done with no samples and  **
+** INA_TRANSFER_ERROR. The return value is false if a readRawAsync() of any INA226_Multi instance or one of the   **
+** buses is still running, in which case nothing is started. The bus callbacks may come from different interrupt  **
+** handlers, but they must not run at the same time on different cores.                                           **
+*******************************************************************************************************************/
+bool INA226_Multi::readRawAsync(INA226_Sample samples[],                      // Read all buses concurrently      //
+                                INA226_AsyncCallback callback) {              //                                  //
+  if (_AsyncInstance!=NULL || callback==NULL) return false;                   // Only one at a time               //
+  uint8_t busesUsed = 0;                                                      // Buses with devices               //
+  for(uint8_t i=0;i<_BusCount;i++) {                                          // and not while a bus is busy      //
+    if (_Buses[i].asyncBusy()) return false;                                  //                                  //
+    if (_FirstDevice[i]<_FirstDevice[i+1]) busesUsed++;                       //                                  //
+    _AsyncCount[i] = 0;                                                       //                                  //
+  } // for-next each bus                                                      //                                  //
+  _AsyncInstance = this;                                                      // Store the request                //
+  _AsyncSamples  = samples;                                                   //                                  //
+  _AsyncCallback = callback;                                                  //                                  //
+  _AsyncStatus   = 0;                                                         //                                  //
+  _AsyncPending  = busesUsed+1;                                               // One more until all are started   //
+  for(uint8_t i=0;i<_BusCount;i++) {                                          // Start each bus with devices with //
+    if (_FirstDevice[i]==_FirstDevice[i+1]) continue;                         // its part of the samples array    //
+    if (!_Buses[i].readRawAsync(&samples[_FirstDevice[i]],asyncDone)) {       // A bus that can't start is done   //
+      asyncDone(NULL,0,INA_TRANSFER_ERROR);                                   // at once with an error, so that   //
+    } // of if-then bus not started                                           // the request still finishes       //
+  } // for-next each bus                                                      //                                  //
+  asyncDone(NULL,0,0);                                                        // All started, release the extra   //
+  return true;                                                                //                                  //
+} // of method readRawAsync()                                                 //                                  //
+/*******************************************************************************************************************
+** Method asyncBusy returns true while a readRawAsync() request is still running.                                 **
+*******************************************************************************************************************/
+bool INA226_Multi::asyncBusy() {                                              // True while readRawAsync() runs   //
+  return _AsyncInstance==this;                                                //                                  //
+} // of method asyncBusy()                                                    //                                  //
+/*******************************************************************************************************************
+** Method asyncDone is the callback of the readRawAsync() of each bus. The bus is found from the part of the      **
+** samples array, its samples are renumbered, and when the last bus is done the samples are moved together and    **
+** the callback of readRawAsync() is called. It is also called once with NULL samples after all the buses have    **
+** been started, so that buses which finish at once can't end the request early. Since it is called from the main **
+** program, for blocking transports and for that last call, as well as from bus interrupt handlers, the pending   **
+** count and status are updated with interrupts off, restoring the previous state afterwards.                     **
+*******************************************************************************************************************/
+void INA226_Multi::asyncDone(INA226_Sample samples[],const uint8_t count,     // Completion of one bus            //
+                             const uint8_t status) {                          //                                  //
+  INA226_Multi *multi = _AsyncInstance;                                       // Instance with reads running      //
+  if (multi==NULL) return;                                                    // Ignore stray completions         //
+  for(uint8_t i=0;samples!=NULL && i<multi->_BusCount;i++) {                  // Find the bus from the samples    //
+    if (samples==&multi->_AsyncSamples[multi->_FirstDevice[i]] &&             //                                  //
+        multi->_FirstDevice[i]<multi->_FirstDevice[i+1]) {                    // skipping buses without devices   //
+      for(uint8_t j=0;j<count;j++) {                                          // Renumber the samples             //
+        samples[j].deviceNumber += multi->_FirstDevice[i];                    //                                  //
+      } // for-next each sample                                               //                                  //
+      multi->_AsyncCount[i] = count;                                          //                                  //
+      break;                                                                  //                                  //
+    } // of if-then bus found                                                 //                                  //
+  } // for-next each bus                                                      //                                  //
+  uint32_t state = inaSaveInterrupts();                                       // Callbacks from the main context  //
+  if (status!=0 && multi->_AsyncStatus==0) multi->_AsyncStatus = status;      // and from other bus interrupts    //
+  bool lastOne = (--multi->_AsyncPending==0);                                 // must not interrupt this read-    //
+  inaRestoreInterrupts(state);                                                // modify-write of the count        //
+  if (!lastOne) return;                                                       // Done unless it was the last one  //
+  uint8_t samplesRead = 0;                                                    // Move the samples together        //
+  for(uint8_t i=0;i<multi->_BusCount;i++) {                                   //                                  //
+    if (multi->_FirstDevice[i]==multi->_FirstDevice[i+1]) continue;           // Skip buses without devices       //
+    for(uint8_t j=0;j<multi->_AsyncCount[i];j++) {                            //                                  //
+      multi->_AsyncSamples[samplesRead++] =                                   //                                  //
+        multi->_AsyncSamples[multi->_FirstDevice[i]+j];                       //                                  //
+    } // for-next each sample                                                 //                                  //
+  } // for-next each bus                                                      //                                  //
+  _AsyncInstance = NULL;                                                      // Request is finished              //
+  multi->_AsyncCallback(multi->_AsyncSamples,samplesRead,multi->_AsyncStatus);//                                  //
+} // of method asyncDone()                                                    //                                  //
+/*******************************************************************************************************************
+** The INA226_SampleBuffer class is a lock-free single-producer/single-consumer ring buffer. Only the producer    **
+** writes _Head, _Dropped and _LastMicros and only the consumer writes _Tail, and the memory barriers make sure   **
+** that a sample has been completely copied before the counter which makes it visible is changed.                 **
+*******************************************************************************************************************/
+INA226_SampleBuffer::INA226_SampleBuffer(INA226_Sample *storage,              // Class constructor                //
+                                         const uint8_t capacity) :            //                                  //
+  _Storage(storage), _Mask(capacity-1) {}                                     //                                  //
+/*******************************************************************************************************************
+** Method push is called by the producer to add a sample to the buffer. The deltaMicros field is set to the time  **
+** since the previous stored sample, limited to 65535. If the buffer is full the sample is counted as dropped and **
+** false is returned.                                                                                             **
+*******************************************************************************************************************/
+bool INA226_SampleBuffer::push(const INA226_Sample &sample,                   // Add sample, false if full        //
+                               const uint32_t timeMicros) {                   //                                  //
+  uint8_t head = _Head;                                                       // Local copy of producer counter   //
+  if ((uint8_t)(head-_Tail)>_Mask) {                                          // If the buffer is full, then      //
+    _Dropped = _Dropped+1;                                                    // count the sample as lost         //
+    return false;                                                             //                                  //
+  } // of if-then buffer full                                                 //                                  //
+  uint32_t deltaMicros = timeMicros-_LastMicros;                              // Time since last stored sample    //
+  INA226_Sample &slot  = _Storage[head&_Mask];                                // Element to be written            //
+  slot             = sample;                                                  // Copy the sample in               //
+  slot.deltaMicros = (deltaMicros>UINT16_MAX) ? UINT16_MAX : deltaMicros;     // and add the timestamp            //
+  _LastMicros      = timeMicros;                                              //                                  //
+  INA_MEMORY_BARRIER();                                                       // Sample written before head moves //
+  _Head = head+1;                                                             // Make sample visible to consumer  //
+  return true;                                                                //                                  //
+} // of method push()                                                         //                                  //
+/*******************************************************************************************************************
+** Method pop is called by the consumer to remove the oldest sample from the buffer, returning false if empty.    **
+*******************************************************************************************************************/
+bool INA226_SampleBuffer::pop(INA226_Sample &sample) {                        // Get sample, false if empty       //
+  uint8_t tail = _Tail;                                                       // Local copy of consumer counter   //
+  if (tail==_Head) return false;                                              // Return if buffer is empty        //
+  INA_MEMORY_BARRIER();                                                       // Head read before sample is read  //
+  sample = _Storage[tail&_Mask];                                              // Copy out the sample              //
+  INA_MEMORY_BARRIER();                                                       // Sample read before tail moves    //
+  _Tail = tail+1;                                                             // Free the element for producer    //
+  return true;                                                                //                                  //
+} // of method pop()                                                          //                                  //
+/*******************************************************************************************************************
+** Method available returns the number of samples in the buffer                                                   **
+*******************************************************************************************************************/
+uint8_t INA226_SampleBuffer::available() {                                    // Number of samples in buffer      //
+  return (uint8_t)(_Head-_Tail);                                              // Counters are free-running        //
+} // of method available()                                                    //                                  //
+/*******************************************************************************************************************
+** Method capacity returns the maximum number of samples the buffer can hold                                      **
+*******************************************************************************************************************/
+uint8_t INA226_SampleBuffer::capacity() {                                     // Maximum samples in buffer        //
+  return _Mask+1;                                                             //                                  //
+} // of method capacity()                                                     //                                  //
+/*******************************************************************************************************************
+** Method dropped returns the number of samples that have been lost because the buffer was full. The count is     **
+** never reset, so the consumer can check how many were lost between two calls. Since the 32-bit value can't be   **
+** read in one go on 8-bit processors it is read until two reads match.                                           **
+*******************************************************************************************************************/
+uint32_t INA226_SampleBuffer::dropped() {                                     // Samples lost, buffer was full    //
+  uint32_t droppedSamples;                                                    // Local copy of counter            //
+  do {                                                                        // Read until the value is stable   //
+    droppedSamples = _Dropped;                                                //                                  //
+  } while (droppedSamples!=_Dropped);                                         //                                  //
+  return droppedSamples;                                                      //                                  //
+} // of method dropped()                                                      //                                  //
+/*******************************************************************************************************************
+** Method clear is called by the consumer to discard all samples in the buffer                                    **
+*******************************************************************************************************************/
+void INA226_SampleBuffer::clear() {                                           // Discard all samples              //
+  _Tail = _Head;                                                              // Nothing left to read             //
+} // of method clear()                                                        //                                  //
+/*******************************************************************************************************************
+** Class constructor for the frame encoder, output is where the frames are written and deltaEncoding selects      **
+** delta frames, see INA226.h for the frame layout.                                                               **
+*******************************************************************************************************************/
+INA226_FrameEncoder::INA226_FrameEncoder(Print &output,                       // Class constructor                //
+                                         const bool deltaEncoding) :          //                                  //
+  _Output(&output), _Delta(deltaEncoding) {}                                  //                                  //
+/*******************************************************************************************************************
+** Method write encodes the sample as one frame and writes it to the output in a single call. A delta frame is    **
+** written if delta encoding is on and the device has a previous frame since the last key frame, otherwise a raw  **
+** frame. The frame is built on the stack, so no memory is allocated. If the output doesn't take the whole frame, **
+** false is returned and the next frames are raw frames so that the decoder can pick up again.                    **
+*******************************************************************************************************************/
+bool INA226_FrameEncoder::write(const INA226_Sample &sample) {                // Write one frame, false on error  //
+  uint8_t  frame[INA_FRAME_MAX_BYTES];                                        // Frame is built here              //
+  uint8_t  length = 0;                                                        // Bytes in the frame so far        //
+  bool     delta  = false;                                                    // Write the differences            //
+  uint16_t words[4] = {sample.busRaw,(uint16_t)sample.shuntRaw,               // Register words in frame order    //
+                       (uint16_t)sample.currentRaw,sample.powerRaw};          //                                  //
+  if (_Frames>=INA_FRAME_KEY_INTERVAL) reset();                               // Time for raw key frames again    //
+  if (sample.deviceNumber<INA_MAX_DEVICES) {                                  // Only these have a previous frame //
+    INA226_Sample &last = _Last[sample.deviceNumber];                         // Previous frame of the device     //
+    delta = _Delta && bitRead(_Known,sample.deviceNumber);                    //                                  //
+    if (delta) {                                                              // Replace words with differences   //
+      words[0] -= last.busRaw;                                                //                                  //
+      words[1] -= (uint16_t)last.shuntRaw;                                    //                                  //
+      words[2] -= (uint16_t)last.currentRaw;                                  //                                  //
+      words[3] -= last.powerRaw;                                              //                                  //
+    } // of if-then delta frame                                               //                                  //
+    last    = sample;                                                         // Base for the next delta frame    //
+    _Known |= (uint16_t)1<<sample.deviceNumber;                               //                                  //
+  } // of if-then device has a previous frame                                 //                                  //
+  frame[length++] = INA_FRAME_SYNC;                                           // Frame header                     //
+  frame[length++] = delta ? INA_FRAME_DELTA : INA_FRAME_RAW;                  //                                  //
+  frame[length++] = sample.deviceNumber;                                      //                                  //
+  frame[length++] = (uint8_t)sample.deltaMicros;                              //                                  //
+  frame[length++] = (uint8_t)(sample.deltaMicros>>8);                         //                                  //
+  for(uint8_t i=0;i<4;i++) {                                                  // Add the payload                  //
+    if (delta) {                                                              // Zigzag maps small differences of //
+      uint16_t zigzag = (uint16_t)(words[i]<<1)^(uint16_t)-(words[i]>>15);    // either sign to small numbers,    //
+      while (zigzag>=0x80) {                                                  // then write 7 bits per byte with  //
+        frame[length++] = (uint8_t)zigzag|0x80;                               // the top bit set when more follow //
+        zigzag >>= 7;                                                         //                                  //
+      } // of while more bytes follow                                         //                                  //
+      frame[length++] = (uint8_t)zigzag;                                      //                                  //
+    } else {                                                                  // Raw words least significant      //
+      frame[length++] = (uint8_t)words[i];                                    // byte first                       //
+      frame[length++] = (uint8_t)(words[i]>>8);                               //                                  //
+    } // of if-then-else delta frame                                          //                                  //
+  } // of for-next each word                                                  //                                  //
+  frame[length] = crc(frame+1,length-1);                                      // CRC of type up to the payload    //
+  length++;                                                                   //                                  //
+  _Frames++;                                                                  //                                  //
+  if (_Output->write(frame,length)==length) return true;                      // Send the frame in one go         //
+  reset();                                                                    // Frame lost, restart with raw     //
+  return false;                                                               // frames                           //
+} // of method write()                                                        //                                  //
+/*******************************************************************************************************************
+** Method write takes up to maxSamples samples out of the buffer and writes each one as a frame, which lets the   **
+** main loop send samples while service() or the interrupt handler keeps adding them. It returns the number of    **
+** frames written and stops at the first one that can't be written.                                               **
+*******************************************************************************************************************/
+uint8_t INA226_FrameEncoder::write(INA226_SampleBuffer &buffer,               // Write buffered samples           //
+                                   const uint8_t maxSamples) {                //                                  //
+  INA226_Sample sample;                                                       // Sample taken out of the buffer   //
+  uint8_t frames = 0;                                                         // Frames written                   //
+  while (frames<maxSamples && buffer.pop(sample)) {                           // Until done or buffer empty       //
+    if (!write(sample)) break;                                                // Stop if the output failed        //
+    frames++;                                                                 //                                  //
+  } // of while samples to write                                              //                                  //
+  return frames;                                                              //                                  //
+} // of method write()                                                        //                                  //
+/*******************************************************************************************************************
+** Method reset makes the next frame of each device a raw frame, for instance after the receiving end has been    **
+** restarted.                                                                                                     **
+*******************************************************************************************************************/
+void INA226_FrameEncoder::reset() {                                           // Make all next frames raw frames  //
+  _Known  = 0;                                                                //                                  //
+  _Frames = 0;                                                                //                                  //
+} // of method reset()                                                        //                                  //
+/*******************************************************************************************************************
+** Method crc computes the CRC-8 with polynomial 0x07 and an initial value of 0 of the data. It is computed bit   **
+** by bit instead of with a table to save the 256 bytes the table would need.                                     **
+*******************************************************************************************************************/
+uint8_t INA226_FrameEncoder::crc(const uint8_t data[],const uint8_t length) { // CRC-8 of the data                //
+  uint8_t value = 0;                                                          //                                  //
+  for(uint8_t i=0;i<length;i++) {                                             // For each byte                    //
+    value ^= data[i];                                                         //                                  //
+    for(uint8_t bit=0;bit<8;bit++)                                            // Shift out each bit, subtracting  //
+      value = (value&0x80) ? (value<<1)^0x07 : value<<1;                      // the polynomial if it was set     //
+  } // of for-next each byte                                                  //                                  //
+  return value;                                                               //                                  //
+} // of method crc()                                                          //                                  //
+/*******************************************************************************************************************
+** Method decode is the reference decoder for the frames of INA226_FrameEncoder. It is given the received bytes   **
+** one at a time and returns true when a complete and correct frame has been decoded into sample. Bytes before a  **
+** sync byte are skipped, and a frame with a wrong CRC, an unknown type or a delta frame without a previous raw   **
+** frame of the device is counted as an error and the search for the next sync byte starts again from the byte    **
+** after the bad sync byte. After any error all devices wait for their next raw frame, since a lost delta frame   **
+** can't be detected otherwise.                                                                                   **
+*******************************************************************************************************************/
+bool INA226_FrameDecoder::decode(const uint8_t data,INA226_Sample &sample) {  // Add a byte, true with a sample   //
+  if (_Length==0 && data!=INA_FRAME_SYNC) {                                   // Skip bytes outside of frames,    //
+    _Known = 0;                                                               // frames might have been lost      //
+    return false;                                                             //                                  //
+  } // of if-then not in a frame                                              //                                  //
+  _Frame[_Length++] = data;                                                   // Store the byte                   //
+  uint8_t length = frameLength();                                             // Frame length when complete       //
+  if (length==0) return false;                                                // Wait for more bytes              //
+  bool valid = length!=UINT8_MAX &&                                           // Check the CRC of complete frames //
+               INA226_FrameEncoder::crc(_Frame+1,length-2)==_Frame[length-1]; //                                  //
+  if (valid) {                                                                //                                  //
+    uint16_t words[4];                                                        // Register words in frame order    //
+    uint8_t  position  = 5;                                                   // First payload byte               //
+    uint8_t  device    = _Frame[2];                                           //                                  //
+    bool     delta     = _Frame[1]==INA_FRAME_DELTA;                          //                                  //
+    valid = !delta || (device<INA_MAX_DEVICES && bitRead(_Known,device));     // Deltas need a previous frame     //
+    if (valid) {                                                              //                                  //
+      INA226_Sample &last = _Last[device<INA_MAX_DEVICES ? device : 0];       // Previous frame of the device     //
+      uint16_t base[4] = {last.busRaw,(uint16_t)last.shuntRaw,                //                                  //
+                          (uint16_t)last.currentRaw,last.powerRaw};           //                                  //
+      for(uint8_t i=0;i<4;i++) {                                              // Read the payload                 //
+        if (delta) {                                                          // Collect 7 bits per byte and undo //
+          uint16_t zigzag = 0;                                                // the zigzag mapping               //
+          uint8_t  shift  = 0;                                                //                                  //
+          do {                                                                //                                  //
+            zigzag |= (uint16_t)(_Frame[position]&0x7F)<<shift;               //                                  //
+            shift  += 7;                                                      //                                  //
+          } while (_Frame[position++]&0x80);                                  //                                  //
+          words[i] = base[i]+((zigzag>>1)^(uint16_t)-(zigzag&1));             //                                  //
+        } else {                                                              //                                  //
+          words[i]  = _Frame[position]|(uint16_t)_Frame[position+1]<<8;       //                                  //
+          position += 2;                                                      //                                  //
+        } // of if-then-else delta frame                                      //                                  //
+      } // of for-next each word                                              //                                  //
+      sample.deviceNumber = device;                                           //                                  //
+      sample.deltaMicros  = _Frame[3]|(uint16_t)_Frame[4]<<8;                 //                                  //
+      sample.busRaw       = words[0];                                         //                                  //
+      sample.shuntRaw     = (int16_t)words[1];                                //                                  //
+      sample.currentRaw   = (int16_t)words[2];                                //                                  //
+      sample.powerRaw     = words[3];                                         //                                  //
+      if (device<INA_MAX_DEVICES) {                                           // Base for the next delta frame    //
+        last    = sample;                                                     //                                  //
+        _Known |= (uint16_t)1<<device;                                        //                                  //
+      } // of if-then device has a previous frame                             //                                  //
+    } // of if-then delta base known                                          //                                  //
+  } // of if-then frame is valid                                              //                                  //
+  if (!valid) {                                                               // On errors drop only the sync byte//
+    _Errors++;                                                                // and look for the next one in the //
+    _Known = 0;                                                               // bytes already received           //
+    length = 1;                                                               //                                  //
+    while (length<_Length && _Frame[length]!=INA_FRAME_SYNC) length++;        //                                  //
+  } // of if-then frame not valid                                             //                                  //
+  _Length -= length;                                                          // Keep bytes after the frame       //
+  memmove(_Frame,_Frame+length,_Length);                                      //                                  //
+  return valid;                                                               //                                  //
+} // of method decode()                                                       //                                  //
+/*******************************************************************************************************************
+** Method frameLength returns the total length of the frame in _Frame once all of its bytes have been received, 0 **
+** while bytes are still missing, or UINT8_MAX if it can't be a frame. The length of a delta frame is found by    **
+** following the varints, none of which can be longer than 3 bytes.                                               **
+*******************************************************************************************************************/
+uint8_t INA226_FrameDecoder::frameLength() {                                  // Length if complete, 0 otherwise  //
+  if (_Length<2) return 0;                                                    // Type not received yet            //
+  if (_Frame[1]==INA_FRAME_RAW) return (_Length>=14) ? 14 : 0;                // Raw frames have a fixed length   //
+  if (_Frame[1]!=INA_FRAME_DELTA) return UINT8_MAX;                           // Unknown frame type               //
+  uint8_t position = 5;                                                       // First payload byte               //
+  for(uint8_t i=0;i<4;i++) {                                                  // Skip the 4 varints               //
+    uint8_t bytes = 0;                                                        //                                  //
+    do {                                                                      //                                  //
+      if (position>=_Length) return 0;                                        //                                  //
+      if (++bytes>3) return UINT8_MAX;                                        //                                  //
+    } while (_Frame[position++]&0x80);                                        //                                  //
+  } // of for-next each varint                                                //                                  //
+  return (position<_Length) ? position+1 : 0;                                 // Complete when the CRC is there   //
+} // of method frameLength()                                                  //                                  //
+/*******************************************************************************************************************
+** Method errors returns the number of frames which could not be decoded since the decoder was created.           **
+*******************************************************************************************************************/
+uint32_t INA226_FrameDecoder::errors() {                                      // Frames lost or corrupted         //
+  return _Errors;                                                             //                                  //
+} // of method errors()                                                       //                                  //
+/*******************************************************************************************************************
+** Method reset discards a partly received frame and the previous frames of all devices, for instance when the    **
+** connection has been reopened.                                                                                  **
+*******************************************************************************************************************/
+void INA226_FrameDecoder::reset() {                                           // Discard partial frame and state  //
+  _Length = 0;                                                                //                                  //
+  _Known  = 0;                                                                //                                  //
+} // of method reset()                                                        //----------------------------------//
@@ -33,6 +33,68 @@
 **                                                                                                                **
 ** Vers.  Date       Developer                     Comments                                                       **
 ** ====== ========== ============================= ============================================================== **
+** 1.0.36 2026-10-14 https://github.com/SV-Zanshin Added calibrateCurrent() and setCorrection() for a per-device  **
+**                                                 gain and offset correction of the shunt, stored with           **
+**                                                 saveConfig() and applied in the fixed-point multipliers or the **
+**                                                 calibration register                                           **
+** 1.0.35 2026-10-14 https://github.com/SV-Zanshin Added INA226_Config and configure() to apply several           **
+**                                                 configuration changes with one write per device, skipping      **
+**                                                 devices that don't change                                      **
+** 1.0.34 2026-10-14 https://github.com/SV-Zanshin Added sampleLowPower() for duty-cycled sampling, which         **
+**                                                 triggers, sleeps until ALERT and powers the devices down again **
+** 1.0.33 2026-10-14 https://github.com/SV-Zanshin Added INA226_FrameEncoder for compact binary sample frames     **
+**                                                 with optional delta/zigzag encoding and a CRC-8, and the       **
+**                                                 INA226_FrameDecoder reference decoder                          **
+** 1.0.32 2026-10-14 https://github.com/SV-Zanshin Replaced debug_Mode Serial output with a log sink,             **
+**                                                 INA_LOG_LEVEL filters at compile time and events are stored    **
+**                                                 raw for setLogCallback() or setLogBuffer() and formatted later **
+**                                                 with formatLog()                                               **
+** 1.0.31 2026-10-14 https://github.com/SV-Zanshin Added INA_INSTRUMENTATION counters with getCounters(), removed **
+**                                                 stray Serial output from getters                               **
+** 1.0.30 2026-10-14 https://github.com/SV-Zanshin Added setBusClock() for Fast-mode, Fast-mode Plus and HS mode  **
+**                                                 with master code                                               **
+** 1.0.29 2026-10-14 https://github.com/SV-Zanshin Added INA226_Multi to sample several I2C buses with global     **
+**                                                 device numbers                                                 **
+** 1.0.28 2026-10-14 https://github.com/SV-Zanshin Added INA226_Transport interface, setWire(), setTransport()    **
+**                                                 and readRawAsync() background reads                            **
+** 1.0.27 2026-10-14 https://github.com/SV-Zanshin Per-device getAveraging(), getBusConversion(),                 **
+**                                                 getShuntConversion(), getMode() defaults to device 0, waits    **
+**                                                 only for the device read                                       **
+** 1.0.26 2026-10-14 https://github.com/SV-Zanshin Added INA226_Adaptive averaging controller with hysteresis,    **
+**                                                 setAdaptive()                                                  **
+** 1.0.25 2026-10-14 https://github.com/SV-Zanshin Added INA226_Filter boxcar decimator and moving average stage, **
+**                                                 setFilter()                                                    **
+** 1.0.24 2026-10-14 https://github.com/SV-Zanshin Added INA226_Statistics running min/max/mean/deviation/RMS per **
+**                                                 device, setStatistics() and getStatistics()                    **
+** 1.0.23 2026-10-14 https://github.com/SV-Zanshin Added setAlertLimit(), getAlertLimit(), getAlertFlag() and     **
+**                                                 startAlertCapture() for limit alerts                           **
+** 1.0.22 2026-10-14 https://github.com/SV-Zanshin Added per-device charge and energy accumulators fed by the     **
+**                                                 sampling engines, INA_NO_ENERGY                                **
+** 1.0.21 2026-10-14 https://github.com/SV-Zanshin Added raw register accessors, readRaw(), readRawAll() batch    **
+**                                                 mode and raw conversion helpers                                **
+** 1.0.20 2026-10-14 https://github.com/SV-Zanshin Added INA226_Fixed template for fixed hardware layouts with    **
+**                                                 compile time calibration                                       **
+** 1.0.19 2026-10-14 https://github.com/SV-Zanshin Conversions use a precomputed multiplier and shift instead of  **
+**                                                 64 bit divisions, added constexpr INA226_Scale                 **
+** 1.0.18 2026-10-14 https://github.com/SV-Zanshin Added begin() overloads taking an address list or bitmask with **
+**                                                 optional reset, scan now includes 0x4F                         **
+** 1.0.17 2026-10-14 https://github.com/SV-Zanshin Added triggerAll() and collectAll() to convert on all devices  **
+**                                                 at the same time                                               **
+** 1.0.16 2026-10-14 https://github.com/SV-Zanshin Added getConversionPeriod(), nextReadyMicros() and             **
+**                                                 serviceSchedule() to read devices only when data is due        **
+** 1.0.15 2026-10-14 https://github.com/SV-Zanshin Added waitForConversion() with timeout and device bitmask,     **
+**                                                 getConversionMicros()                                          **
+** 1.0.14 2026-10-14 https://github.com/SV-Zanshin Sample buffer is now a lock-free INA226_RingBuffer template of **
+**                                                 packed raw samples with timestamps and a dropped sample count  **
+** 1.0.13 2026-10-14 https://github.com/SV-Zanshin Added interrupt-driven sampling engine                         **
+**                                                 startSampling()/service() and INA226_SampleBuffer              **
+** 1.0.12 2026-10-14 https://github.com/SV-Zanshin Added setFastPoll() to skip register pointer writes when       **
+**                                                 already set                                                    **
+** 1.0.11 2026-10-14 https://github.com/SV-Zanshin Added setI2CDelay() and INA_NO_I2C_DELAY, poll for reset end   **
+** 1.0.10 2026-10-14 https://github.com/SV-Zanshin Added readAll() to read all four measurements in one call      **
+** 1.0.9  2026-10-14 https://github.com/SV-Zanshin Cache configuration and mask/enable registers in device table  **
+** 1.0.8  2026-10-14 https://github.com/SV-Zanshin Device table held in RAM, EEPROM only used by saveConfig() and **
+**                                                 loadConfig(). Fixed include guard and per-device loop indexing **
 ** 1.0.7  2018-06-08 https://github.com/SV-Zanshin https://github.com/SV-Zanshin/INA226/issues/14. Missing calls  **
 **                                                 EEPROM.Get() for device number caused errors sporadic errors   **
 ** 1.0.6  2018-06-01 https://github.com/SV-Zanshin https://github.com/SV-Zanshin/INA226/issues/12. Add getMode()  **
@@ -52,9 +114,52 @@
 **                                                                                                                **
 *******************************************************************************************************************/
 #include "Arduino.h"                                                          // Arduino data type definitions    //
+#include <Wire.h>                                                             // I2C Library, used by INA226_Fixed//
 #ifndef INA226_Class_h                                                        // Guard code definition            //
-  #define debug_Mode                                                          // Comment out when not needed      //
-  #define INA226__Class_h                                                     // Define the name inside guard code//
+  //#define INA_NO_I2C_DELAY                                                  // Uncomment to remove read delays  //
+  //#define INA_NO_ENERGY                                                     // Uncomment to remove accumulators //
+  //#define INA_INSTRUMENTATION                                               // Uncomment to count I2C traffic   //
+  //#define INA_WIRE_HS_MODE                                                  // Uncomment if Wire keeps the bus  //
+                                                                              // after the NACKed HS master code  //
+  #define INA226_Class_h                                                      // Define the name inside guard code//
+  #ifndef INA_MAX_DEVICES                                                     // Allow override from the build    //
+    #define INA_MAX_DEVICES 16                                                // Size of the RAM device table     //
+  #endif                                                                      //                                  //
+  #if INA_MAX_DEVICES>16                                                      // Device bitmasks are 16 bits wide //
+    #error INA_MAX_DEVICES cannot exceed 16, the number of INA226 addresses   //                                  //
+  #endif                                                                      //                                  //
+  #if defined(__AVR__)                                                        // Single core, a compiler barrier  //
+    #define INA_MEMORY_BARRIER() __asm__ __volatile__("" ::: "memory")        // is enough to keep ring buffer    //
+  #else                                                                       // accesses in order. Otherwise use //
+    #define INA_MEMORY_BARRIER() __sync_synchronize()                         // a full hardware memory barrier   //
+  #endif                                                                      //                                  //
+  #ifndef INA_SLEEP_MODE                                                      // AVR sleep mode used while        //
+    #define INA_SLEEP_MODE SLEEP_MODE_IDLE                                    // sampleLowPower() waits for ALERT //
+  #endif                                                                      //                                  //
+  #ifndef INA_MAX_BUSES                                                       // Allow override from the build    //
+    #define INA_MAX_BUSES 4                                                   // Buses in one INA226_Multi        //
+  #endif                                                                      //                                  //
+  #define INA_LOG_NONE    0                                                   // Log levels, INA_LOG_LEVEL selects//
+  #define INA_LOG_ERROR   1                                                   // the most detailed one compiled in//
+  #define INA_LOG_WARNING 2                                                   //                                  //
+  #define INA_LOG_INFO    3                                                   //                                  //
+  #define INA_LOG_DEBUG   4                                                   //                                  //
+  #ifndef INA_LOG_LEVEL                                                       // Allow override from the build,   //
+    #define INA_LOG_LEVEL INA_LOG_NONE                                        // default is no logging at all     //
+  #endif                                                                      //                                  //
+  #if INA_LOG_LEVEL>INA_LOG_NONE                                              // Log calls above the level are    //
+    #define INA_LOG(l,e,a,v) ((l)<=INA_LOG_LEVEL?logEvent(l,e,a,v):(void)0)   // removed by the compiler, with    //
+  #else                                                                       // INA_LOG_NONE no logging code is  //
+    #define INA_LOG(l,e,a,v) ((void)0)                                        // compiled in at all               //
+  #endif                                                                      //                                  //
+  #ifdef INA_INSTRUMENTATION                                                  // Instrumentation statements are   //
+    #define INA_INSTRUMENT(statement) statement                               // only compiled in on demand       //
+  #else                                                                       //                                  //
+    #define INA_INSTRUMENT(statement)                                         //                                  //
+  #endif                                                                      //                                  //
+  #ifndef INA_EEPROM_ADDRESS                                                  // Allow override from the build    //
+    #define INA_EEPROM_ADDRESS 0                                              // Start of saveConfig() EEPROM area//
+  #endif                                                                      //                                  //
   /*****************************************************************************************************************
   ** Declare structures used in the class                                                                         **
   *****************************************************************************************************************/
@@ -63,12 +168,77 @@
     uint16_t calibration;                                                     // Calibration register value       //
     uint32_t current_LSB;                                                     // Amperage LSB                     //
     uint32_t power_LSB;                                                       // Wattage LSB                      //
+    uint32_t current_Mult;                                                    // current_LSB/100000 as multiplier //
+    uint8_t  current_Shift;                                                   // and shift for fast conversion    //
+    uint32_t power_Mult;                                                      // power_LSB/1000 as a multiplier   //
+    uint8_t  power_Shift;                                                     // and shift for fast conversion    //
     uint8_t  operatingMode;                                                   // Default continuous mode operation//
+    uint16_t configuration;                                                   // Shadow of configuration register //
+    uint16_t maskEnable;                                                      // Shadow of mask/enable register   //
+    uint16_t alertLimit;                                                      // Shadow of alert limit register   //
+    uint16_t gain;                                                            // Gain correction, 32768 is 1.0    //
+    int16_t  currentOffset;                                                   // Offset correction, current LSBs  //
+    bool     gainInRegister;                                                  // Gain applied in calibration reg  //
   } inaDet; // of structure                                                   //                                  //
+  typedef struct {                                                            // Header of saved EEPROM table     //
+    uint16_t signature;                                                       // Identifies a valid saved table   //
+    uint8_t  structSize;                                                      // sizeof(inaDet) when it was saved //
+    uint8_t  deviceCount;                                                     // Number of devices saved          //
+  } inaEEPROMHeader; // of structure                                          //                                  //
+  typedef struct {                                                            // Structure filled by readAll()    //
+    uint8_t  deviceNumber;                                                    // Device the values belong to      //
+    uint16_t busMilliVolts;                                                   // Bus voltage in mV                //
+    int32_t  shuntMicroVolts;                                                 // Shunt voltage in uV              //
+    int32_t  busMicroAmps;                                                    // Current in uA                    //
+    int32_t  busMicroWatts;                                                   // Power in uW                      //
+  } INA226_Reading; // of structure                                           //                                  //
+  typedef struct {                                                            // Running totals of one register   //
+    int32_t  first;                                                           // First value, sums are relative   //
+    int32_t  minimum;                                                         // Smallest raw value               //
+    int32_t  maximum;                                                         // Largest raw value                //
+    int64_t  sum;                                                             // Sum of value-first               //
+    uint64_t sumSquares;                                                      // Sum of (value-first)^2           //
+  } inaStatChannel; // of structure                                           //                                  //
+  typedef struct {                                                            // Structure filled by              //
+    uint32_t       count;                                                     // getStatistics()                  //
+    INA226_Reading minimum;                                                   // Smallest values                  //
+    INA226_Reading maximum;                                                   // Largest values                   //
+    INA226_Reading mean;                                                      // Average values                   //
+    INA226_Reading deviation;                                                 // Standard deviations              //
+    INA226_Reading rms;                                                       // Root mean square values          //
+  } INA226_Summary; // of structure                                           //                                  //
+  typedef struct {                                                            // Structure filled by getCounters()//
+    uint32_t transactions;                                                    // I2C transactions started         //
+    uint32_t bytes;                                                           // Bytes written and read           //
+    uint32_t nacks;                                                           // Transactions that failed         //
+    uint32_t waitMicros;                                                      // Time in waitForConversion()      //
+    uint32_t eepromMicros;                                                    // Time in EEPROM accesses          //
+  } INA226_Counters; // of structure                                          //                                  //
+  typedef struct {                                                            // Log event, stored unformatted    //
+    uint32_t micros;                                                          // micros() when logged             //
+    uint8_t  level;                                                           // INA_LOG_ERROR to INA_LOG_DEBUG   //
+    uint8_t  event;                                                           // One of the INA_EVENT constants   //
+    uint8_t  address;                                                         // Device address, 0 if none        //
+    int32_t  value;                                                           // Value belonging to the event     //
+  } INA226_LogEntry; // of structure                                          //                                  //
+  typedef void (*INA226_LogCallback)(const INA226_LogEntry &entry);           // Log sink called for each event   //
+  typedef struct __attribute__((packed)) {                                    // Compact sample for sample buffer //
+    uint8_t  deviceNumber;                                                    // Device the values belong to      //
+    uint16_t deltaMicros;                                                     // Time since previous sample, uS   //
+    uint16_t busRaw;                                                          // Raw bus voltage register         //
+    int16_t  shuntRaw;                                                        // Raw shunt voltage register       //
+    int16_t  currentRaw;                                                      // Raw current register             //
+    uint16_t powerRaw;                                                        // Raw power register               //
+  } INA226_Sample; // of structure                                            //                                  //
   /*****************************************************************************************************************
   ** Declare constants used in the class                                                                          **
   *****************************************************************************************************************/
   const uint8_t  I2C_DELAY                    =     10;                       // Microsecond delay on write       //
+  const uint8_t  INA_RESET_TIMEOUT            =     10;                       // Maximum milliseconds for a reset //
+  const uint8_t  INA_POINTER_UNKNOWN          =   0x80;                       // Register pointer not known       //
+  const uint16_t INA_ALL_DEVICES              = 0xFFFF;                       // Bitmask selecting every device   //
+  const uint32_t INA_AUTO_TIMEOUT             =      0;                       // Timeout from conversion periods  //
+  const uint8_t  INA_POINTER_INDEX_MASK       =   0x0F;                       // Address bits selecting 1 of 16   //
   const uint8_t  INA_CONFIGURATION_REGISTER   =      0;                       // Registers common to all INAs     //
   const uint8_t  INA_SHUNT_VOLTAGE_REGISTER   =      1;                       //                                  //
   const uint8_t  INA_BUS_VOLTAGE_REGISTER     =      2;                       //                                  //
@@ -76,16 +246,57 @@
   const uint8_t  INA_CURRENT_REGISTER         =      4;                       //                                  //
   const uint8_t  INA_CALIBRATION_REGISTER     =      5;                       //                                  //
   const uint8_t  INA_MASK_ENABLE_REGISTER     =      6;                       //                                  //
+  const uint8_t  INA_ALERT_LIMIT_REGISTER     =      7;                       //                                  //
   const uint8_t  INA_MANUFACTURER_ID_REGISTER =   0xFE;                       //                                  //
   const uint16_t INA_RESET_DEVICE             = 0x8000;                       // Write to configuration to reset  //
   const uint16_t INA_DEFAULT_CONFIGURATION    = 0x4127;                       // Default configuration register   //
+  const uint16_t INA_EEPROM_SIGNATURE         = 0x2260;                       // Marks a saveConfig() EEPROM table//
   const uint16_t INA_BUS_VOLTAGE_LSB          =    125;                       // LSB in uV *100 1.25mV            //
   const uint16_t INA_SHUNT_VOLTAGE_LSB        =     25;                       // LSB in uV *10  2.5uV             //
   const uint16_t INA_CONFIG_AVG_MASK          = 0x0E00;                       // Bits 9-11                        //
   const uint16_t INA_CONFIG_BUS_TIME_MASK     = 0x01C0;                       // Bits 6-8                         //
   const uint16_t INA_CONFIG_SHUNT_TIME_MASK   = 0x0038;                       // Bits 3-5                         //
-  const uint16_t INA_CONVERSION_READY_MASK    = 0x0080;                       // Bit 4                            //
+  const uint16_t INA_CONVERSION_READY_MASK    = 0x0008;                       // Bit 3 of mask/enable register    //
   const uint16_t INA_CONFIG_MODE_MASK         = 0x0007;                       // Bits 0-3                         //
+  const uint16_t INA_CONFIG_FIXED_MASK        = 0xF000;                       // Bits 12-15, reset and read-only  //
+  const uint16_t INA_ALERT_CONFIG_MASK        = 0xFC03;                       // Writable mask/enable bits        //
+  const uint16_t INA_ALERT_FUNCTION_MASK      = 0xF800;                       // Bits 11-15, limit alert functions//
+  const uint16_t INA_ALERT_FUNCTION_FLAG      = 0x0010;                       // Bit 4, limit has been exceeded   //
+  const uint16_t INA_ALERT_LATCH_ENABLE       = 0x0001;                       // Bit 0, latch alert until read    //
+  const uint8_t  INA_ALERT_NONE               =      0;                       // Types for setAlertLimit(), no    //
+  const uint8_t  INA_ALERT_SHUNT_OVER_UV      =      1;                       // limit alert, shunt voltage in uV,//
+  const uint8_t  INA_ALERT_SHUNT_UNDER_UV     =      2;                       // bus voltage in mV, power in uW   //
+  const uint8_t  INA_ALERT_BUS_OVER_MV        =      3;                       // and current in uA. The current   //
+  const uint8_t  INA_ALERT_BUS_UNDER_MV       =      4;                       // limits are converted to shunt    //
+  const uint8_t  INA_ALERT_POWER_OVER_UW      =      5;                       // voltage limits                   //
+  const uint8_t  INA_ALERT_CURRENT_OVER_UA    =      6;                       //                                  //
+  const uint8_t  INA_ALERT_CURRENT_UNDER_UA   =      7;                       //                                  //
+  const uint16_t INA_FILTER_MAX_RATIO         =  32768;                       // Largest ratio, sums fit 32 bits  //
+  const uint8_t  INA_TRANSFER_ERROR           =      4;                       // Wire status for a failed read    //
+  const uint8_t  INA_TRANSFER_PENDING         =   0xFF;                       // startRead() completes later      //
+  const uint32_t INA_I2C_STANDARD_MODE        = 100000;                       // Bus clocks for setBusClock() in  //
+  const uint32_t INA_I2C_FAST_MODE            = 400000;                       // Hz. Clocks above Fast-mode Plus  //
+  const uint32_t INA_I2C_FAST_MODE_PLUS       =1000000;                       // use HS mode, which is entered    //
+  const uint32_t INA_I2C_HIGH_SPEED_MODE      =2940000;                       // with the master code at 400kHz   //
+  const uint8_t  INA_HS_MASTER_CODE           =   0x08;                       // 00001xxx, sent as address 0x04   //
+  const uint16_t INA_GAIN_UNITY               =  32768;                       // Gain correction of 1.0           //
+  const uint16_t INA_WAKE_MICROS              =    100;                       // Margin for the MCU waking up     //
+  const uint16_t INA_CONVERSION_ALERT_ENABLE  = 0x0400;                       // Bit 10, ALERT on conversion ready//
+  const uint8_t  INA_FRAME_SYNC               =   0xA5;                       // First byte of every binary frame //
+  const uint8_t  INA_FRAME_RAW                =   0x01;                       // Frame types, raw register words  //
+  const uint8_t  INA_FRAME_DELTA              =   0x02;                       // or zigzag varint differences     //
+  const uint8_t  INA_FRAME_MAX_BYTES          =     18;                       // Longest frame, a delta frame     //
+  const uint8_t  INA_FRAME_KEY_INTERVAL       =     32;                       // Frames between raw key frames    //
+  const uint8_t  INA_EVENT_DEVICE_FOUND       =      0;                       // Device found, value is config    //
+  const uint8_t  INA_EVENT_RESET              =      1;                       // Device reset, value is config    //
+  const uint8_t  INA_EVENT_CALIBRATION        =      2;                       // Calibration register written     //
+  const uint8_t  INA_EVENT_CURRENT_LSB        =      3;                       // Current LSB in nA                //
+  const uint8_t  INA_EVENT_POWER_LSB          =      4;                       // Power LSB in nA                  //
+  const uint8_t  INA_EVENT_CONFIG_LOADED      =      5;                       // Devices loaded from EEPROM       //
+  const uint8_t  INA_EVENT_I2C_ERROR          =      6;                       // I2C failure, value is status     //
+  const uint8_t  INA_EVENT_TIMEOUT            =      7;                       // Wait timed out, value is uS      //
+  const uint8_t  INA_EVENT_BUFFER_FULL        =      8;                       // Sample dropped, value is count   //
+  const uint8_t  INA_EVENT_CONFIGURATION      =      9;                       // Config register written          //
   const uint8_t  INA_MODE_TRIGGERED_SHUNT     =   B001;                       // Triggered shunt, no bus          //
   const uint8_t  INA_MODE_TRIGGERED_BUS       =   B010;                       // Triggered bus, no shunt          //
   const uint8_t  INA_MODE_TRIGGERED_BOTH      =   B011;                       // Triggered bus and shunt          //
@@ -94,6 +305,345 @@
   const uint8_t  INA_MODE_CONTINUOUS_BUS      =   B110;                       // Continuous bus, no shunt         //
   const uint8_t  INA_MODE_CONTINUOUS_BOTH     =   B111;                       // Both continuous, default value   //
   /*****************************************************************************************************************
+  ** Declare the constexpr conversion helpers. Dividing by the LSBs with 64 bit numbers takes hundreds of cycles  **
+  ** on 8-bit processors, so each LSB is instead turned into a 16 bit multiplier and a shift once, so that a      **
+  ** conversion is one 32 bit multiplication and shift. The shift is the largest one which keeps the multiplier   **
+  ** below 65536, so the multiplier is at least 32768 unless the factor is tiny. The rounded multiplier is then   **
+  ** out by at most 1 part in 65536, and the shift rounds the result down instead of towards zero, so a converted **
+  ** value is within 0.0016% + 2uA (or 2uW) of the 64 bit division. Power factors of 65536 and more, which only   **
+  ** occur with a maxBusAmps above 85, are used as is with a shift of 0. Since they are constexpr the same        **
+  ** functions compute the values at compile time when the shunt and maximum current are constants, either        **
+  ** directly or through the INA226_Scale template.                                                               **
+  *****************************************************************************************************************/
+  constexpr uint32_t inaCurrentLSB(const uint8_t maxBusAmps) {                // Best possible current LSB in nA  //
+    return (uint64_t)maxBusAmps*1000000000/32767;                             //                                  //
+  } // of function inaCurrentLSB()                                            //                                  //
+  constexpr uint16_t inaCalibration(const uint32_t currentLSB,                // Calibration register for the LSB //
+                                    const uint32_t microOhmR) {               // and shunt resistance             //
+    return (uint64_t)51200000/((uint64_t)currentLSB*microOhmR/100000);        //                                  //
+  } // of function inaCalibration()                                           //                                  //
+  constexpr uint8_t inaScaleShift(const uint32_t numerator,                   // Largest shift which keeps the    //
+                                  const uint32_t denominator,                 // multiplier below 65536           //
+                                  const uint8_t  shift=31) {                  //                                  //
+    return (shift==0 || ((uint64_t)numerator<<shift)+denominator/2<           //                                  //
+                        ((uint64_t)denominator<<16)) ? shift :                //                                  //
+           inaScaleShift(numerator,denominator,shift-1);                      //                                  //
+  } // of function inaScaleShift()                                            //                                  //
+  constexpr uint32_t inaScaleMultiplier(const uint32_t numerator,             // Rounded numerator/denominator    //
+                                        const uint32_t denominator,           // multiplied by 2^shift            //
+                                        const uint8_t  shift) {               //                                  //
+    return (((uint64_t)numerator<<shift)+denominator/2)/denominator;          //                                  //
+  } // of function inaScaleMultiplier()                                       //                                  //
+  /*****************************************************************************************************************
+  ** The raw conversion helpers turn untouched register values into units. They are used by the library itself    **
+  ** and can be used by the consumer of raw samples, for example to convert a whole logged batch on the host. The **
+  ** current and power helpers need the multiplier and shift of the device, see inaScaleShift() and               **
+  ** inaScaleMultiplier().                                                                                        **
+  *****************************************************************************************************************/
+  constexpr uint16_t inaBusMilliVolts(const uint16_t busRaw) {                // Convert bus voltage register     //
+    return (uint32_t)busRaw*INA_BUS_VOLTAGE_LSB/100;                          //                                  //
+  } // of function inaBusMilliVolts()                                         //                                  //
+  constexpr int32_t  inaShuntMicroVolts(const int16_t shuntRaw) {             // Convert shunt voltage register   //
+    return (int32_t)shuntRaw*INA_SHUNT_VOLTAGE_LSB/10;                        //                                  //
+  } // of function inaShuntMicroVolts()                                       //                                  //
+  constexpr int32_t  inaMicroAmps(const int16_t currentRaw,                   // Convert current register         //
+                                  const uint32_t multiplier,                  //                                  //
+                                  const uint8_t  shift) {                     //                                  //
+    return ((int32_t)currentRaw*(int32_t)multiplier)>>shift;                  //                                  //
+  } // of function inaMicroAmps()                                             //                                  //
+  constexpr int32_t  inaMicroWatts(const uint16_t powerRaw,                   // Convert power register           //
+                                   const uint32_t multiplier,                 //                                  //
+                                   const uint8_t  shift) {                    //                                  //
+    return ((uint32_t)powerRaw*multiplier)>>shift;                            //                                  //
+  } // of function inaMicroWatts()                                            //                                  //
+  constexpr uint8_t inaAveragingIndex(const uint16_t averages) {              // Configuration register setting   //
+    return averages>=1024 ? 7 : averages>=512 ? 6 : averages>=256 ? 5 :       // for a number of averages         //
+           averages>= 128 ? 4 : averages>= 64 ? 3 : averages>= 16 ? 2 :       //                                  //
+           averages>=   4 ? 1 : 0;                                            //                                  //
+  } // of function inaAveragingIndex()                                        //                                  //
+  /*****************************************************************************************************************
+  ** Declare the interrupt helpers for data shared with interrupt handlers. inaSaveInterrupts() turns interrupts  **
+  ** off and returns the previous state, which inaRestoreInterrupts() puts back, so that the same critical        **
+  ** section can be used from the main program and from an interrupt handler without turning interrupts on inside **
+  ** the handler. The state is SREG on AVR and PRIMASK on ARM Cortex-M processors, other platforms use            **
+  ** noInterrupts() and interrupts().                                                                             **
+  *****************************************************************************************************************/
+  inline uint32_t inaSaveInterrupts() {                                       // Turn interrupts off and return   //
+    #if defined(__AVR__)                                                      // the previous state               //
+      uint32_t state = SREG;                                                  //                                  //
+      cli();                                                                  //                                  //
+    #elif defined(__arm__)                                                    //                                  //
+      uint32_t state;                                                         //                                  //
+      __asm__ __volatile__("mrs %0, primask" : "=r"(state));                  //                                  //
+      __asm__ __volatile__("cpsid i" ::: "memory");                           //                                  //
+    #else                                                                     //                                  //
+      uint32_t state = 0;                                                     //                                  //
+      noInterrupts();                                                         //                                  //
+    #endif                                                                    //                                  //
+    return state;                                                             //                                  //
+  } // of function inaSaveInterrupts()                                        //                                  //
+  inline void inaRestoreInterrupts(const uint32_t state) {                    // Restore the saved state          //
+    #if defined(__AVR__)                                                      //                                  //
+      SREG = state;                                                           //                                  //
+    #elif defined(__arm__)                                                    //                                  //
+      __asm__ __volatile__("msr primask, %0" :: "r"(state) : "memory");       //                                  //
+    #else                                                                     //                                  //
+      (void)state;                                                            //                                  //
+      interrupts();                                                           //                                  //
+    #endif                                                                    //                                  //
+  } // of function inaRestoreInterrupts()                                     //                                  //
+  template <uint8_t MaxBusAmps,uint32_t MicroOhmR>                            // Conversion values known at       //
+  struct INA226_Scale {                                                       // compile time                     //
+    static constexpr uint32_t currentLSB   = inaCurrentLSB(MaxBusAmps);       //                                  //
+    static constexpr uint16_t calibration  =                                  //                                  //
+      inaCalibration(currentLSB,MicroOhmR);                                   //                                  //
+    static constexpr uint32_t powerLSB     = (uint32_t)25*currentLSB;         //                                  //
+    static constexpr uint8_t  currentShift = inaScaleShift(currentLSB,100000);//                                  //
+    static constexpr uint32_t currentMult  =                                  //                                  //
+      inaScaleMultiplier(currentLSB,100000,currentShift);                     //                                  //
+    static constexpr uint8_t  powerShift   = inaScaleShift(powerLSB,1000);    //                                  //
+    static constexpr uint32_t powerMult    =                                  //                                  //
+      inaScaleMultiplier(powerLSB,1000,powerShift);                           //                                  //
+    static constexpr int32_t  microAmps(const int16_t currentRaw) {           // Convert current register         //
+      return inaMicroAmps(currentRaw,currentMult,currentShift);               //                                  //
+    } // of method microAmps()                                                //                                  //
+    static constexpr int32_t  microWatts(const uint16_t powerRaw) {           // Convert power register           //
+      return inaMicroWatts(powerRaw,powerMult,powerShift);                    //                                  //
+    } // of method microWatts()                                               //                                  //
+  }; // of INA226_Scale definition                                            //                                  //
+  /*****************************************************************************************************************
+  ** Declare the sample buffer classes. INA226_SampleBuffer is a lock-free single-producer/single-consumer ring   **
+  ** buffer of raw samples, so service() (or an interrupt handler) can add samples while loop() takes them out    **
+  ** without disabling interrupts. Its storage is supplied by the INA226_RingBuffer template, whose Capacity must **
+  ** be a power of 2 from 2 to 128. The head and tail are free-running 8-bit counters, which can be read and      **
+  ** written atomically on every platform.                                                                        **
+  *****************************************************************************************************************/
+  class INA226_SampleBuffer {                                                 // Class definition                 //
+    public:                                                                   // Publicly visible methods         //
+      bool     push(const INA226_Sample &sample,const uint32_t timeMicros);   // Add sample, false if full        //
+      bool     pop(INA226_Sample &sample);                                    // Get sample, false if empty       //
+      uint8_t  available();                                                   // Number of samples in buffer      //
+      uint8_t  capacity();                                                    // Maximum samples in buffer        //
+      uint32_t dropped();                                                     // Samples lost, buffer was full    //
+      void     clear();                                                       // Discard all samples              //
+    protected:                                                                // Only used by INA226_RingBuffer   //
+      INA226_SampleBuffer(INA226_Sample *storage,const uint8_t capacity);     // Class constructor                //
+    private:                                                                  // Private variables and methods    //
+      INA226_Sample    *_Storage;                                             // Storage array from template      //
+      uint8_t           _Mask;                                                // Capacity-1, to index storage     //
+      volatile uint8_t  _Head       = 0;                                      // Samples written, producer owned  //
+      volatile uint8_t  _Tail       = 0;                                      // Samples read, consumer owned     //
+      volatile uint32_t _Dropped    = 0;                                      // Samples lost, producer owned     //
+      uint32_t          _LastMicros = 0;                                      // Time of last sample stored       //
+  }; // of INA226_SampleBuffer definition                                     //                                  //
+  template <uint8_t Capacity>                                                 // Template supplies the storage    //
+  class INA226_RingBuffer : public INA226_SampleBuffer {                      // Class definition                 //
+    static_assert(Capacity>=2 && Capacity<=128 && !(Capacity&(Capacity-1)),   // Masked free-running indices need //
+                  "Capacity must be a power of 2 from 2 to 128");             // a power of 2 capacity            //
+    public:                                                                   // Publicly visible methods         //
+      INA226_RingBuffer() : INA226_SampleBuffer(_Buffer,Capacity) {}          // Class constructor                //
+    private:                                                                  // Private variables and methods    //
+      INA226_Sample _Buffer[Capacity];                                        // Storage for the samples          //
+  }; // of INA226_RingBuffer definition                                       //                                  //
+  /*****************************************************************************************************************
+  ** Declare the binary frame classes. INA226_FrameEncoder writes samples to any Print, such as Serial, as        **
+  ** compact framed binary records instead of text, and INA226_FrameDecoder is the reference decoder which turns  **
+  ** the byte stream back into samples. Neither of them allocates memory. Each frame is the sync byte 0xA5, the   **
+  ** frame type, the device number, the deltaMicros word, the payload and a CRC-8 (polynomial 0x07) of the bytes  **
+  ** from the type to the end of the payload, with all words little-endian. A raw frame (type 0x01) has the bus,  **
+  ** shunt, current and power register words as the payload, 14 bytes in all. A delta frame (type 0x02) has the   **
+  ** differences to the previous frame of the same device instead, each one zigzag encoded and written as a       **
+  ** varint of 7 bits per byte, so values which change little take 1 byte each and a frame as few as 10 bytes.    **
+  ** Devices are sent raw in their first frame and again every INA_FRAME_KEY_INTERVAL frames, so a decoder that   **
+  ** starts late or loses a frame picks up again. Device numbers from INA_MAX_DEVICES upwards are always sent     **
+  ** raw.                                                                                                         **
+  *****************************************************************************************************************/
+  class INA226_FrameEncoder {                                                 // Class definition                 //
+    public:                                                                   // Publicly visible methods         //
+      INA226_FrameEncoder(Print &output,const bool deltaEncoding=false);      // Class constructor                //
+      bool     write(const INA226_Sample &sample);                            // Write one frame, false on error  //
+      uint8_t  write(INA226_SampleBuffer &buffer,                             // Write buffered samples, return   //
+                     const uint8_t maxSamples=UINT8_MAX);                     // the number of frames written     //
+      void     reset();                                                       // Make all next frames raw frames  //
+      static uint8_t crc(const uint8_t data[],const uint8_t length);          // CRC-8 of the data                //
+    private:                                                                  // Private variables and methods    //
+      Print   *_Output;                                                       // Where the frames go              //
+      bool     _Delta;                                                        // Delta frames are allowed         //
+      uint8_t  _Frames = 0;                                                   // Frames since the last key frame  //
+      uint16_t _Known  = 0;                                                   // Devices with a previous frame    //
+      INA226_Sample _Last[INA_MAX_DEVICES];                                   // Previous frame of each device    //
+  }; // of INA226_FrameEncoder definition                                     //                                  //
+  class INA226_FrameDecoder {                                                 // Class definition                 //
+    public:                                                                   // Publicly visible methods         //
+      bool     decode(const uint8_t data,INA226_Sample &sample);              // Add a byte, true with a sample   //
+      uint32_t errors();                                                      // Frames lost or corrupted         //
+      void     reset();                                                       // Discard partial frame and state  //
+    private:                                                                  // Private variables and methods    //
+      uint8_t  frameLength();                                                 // Length if complete, 0 otherwise  //
+      uint8_t  _Frame[INA_FRAME_MAX_BYTES];                                   // Bytes of the frame so far        //
+      uint8_t  _Length = 0;                                                   // Bytes stored in _Frame           //
+      uint16_t _Known  = 0;                                                   // Devices with a previous frame    //
+      uint32_t _Errors = 0;                                                   // Frames that were not decoded     //
+      INA226_Sample _Last[INA_MAX_DEVICES];                                   // Previous frame of each device    //
+  }; // of INA226_FrameDecoder definition                                     //                                  //
+  /*****************************************************************************************************************
+  ** Declare the INA226_Statistics class, which holds the running statistics of one device. Each sample is added  **
+  ** in constant time and RAM using only integer arithmetic, the sums are kept relative to the first sample of    **
+  ** the window so that they are exact and can't lose precision however long the window is. The results are only  **
+  ** worked out, in floating point, when getStatistics() is called. The producer and consumer don't need to       **
+  ** disable interrupts, a sequence counter lets the consumer detect and retry a copy taken while add() was       **
+  ** running, and clear() only requests a new window which add() then starts.                                     **
+  *****************************************************************************************************************/
+  class INA226_Statistics {                                                   // Class definition                 //
+    public:                                                                   // Publicly visible methods         //
+      void     add(const INA226_Sample &sample);                              // Fold a sample into the totals    //
+      void     clear();                                                       // Start a new window               //
+      uint32_t count();                                                       // Samples in the current window    //
+    private:                                                                  // Private variables and methods    //
+      friend class INA226_Class;                                              // getStatistics() reads the totals //
+      inaStatChannel    _Channel[4];                                          // Bus, shunt, current and power    //
+      uint32_t          _Count         = 0;                                   // Samples in the current window    //
+      volatile uint8_t  _Sequence      = 0;                                   // Odd while add() is running       //
+      volatile uint8_t  _ClearRequests = 0;                                   // Incremented by clear()           //
+      uint8_t           _ClearsDone    = 0;                                   // Requests handled by add()        //
+  }; // of INA226_Statistics definition                                       //                                  //
+  /*****************************************************************************************************************
+  ** Declare the INA226_Filter class, an optional software filter stage for one device. It is a boxcar (first     **
+  ** order CIC) decimator which adds up ratio raw samples and puts out their average, followed by an integer      **
+  ** exponential moving average with a factor of 1/2^smoothing. Together with the chip's own averaging this goes  **
+  ** far beyond 1024 averages, or the chip can run with 1 average and the filtering is done here instead. Only    **
+  ** the output samples reach the sample buffer, so it receives one sample for each ratio samples read.           **
+  *****************************************************************************************************************/
+  class INA226_Filter {                                                       // Class definition                 //
+    public:                                                                   // Publicly visible methods         //
+      INA226_Filter(const uint16_t ratio=1,const uint8_t smoothing=0);        // Class constructor                //
+      void     setDecimation(const uint16_t ratio);                           // Samples per output sample        //
+      void     setSmoothing(const uint8_t smoothing);                         // Moving average factor 1/2^n      //
+      bool     filter(INA226_Sample &sample);                                 // True if sample is now an output  //
+      void     clear();                                                       // Restart the filter               //
+    private:                                                                  // Private variables and methods    //
+      int32_t  _Sum[4];                                                       // Sums of the current block        //
+      int32_t  _Average[4];                                                   // Averages times 2^smoothing       //
+      uint16_t _Ratio;                                                        // Decimation ratio                 //
+      uint16_t _Count       = 0;                                              // Samples in the current block     //
+      uint8_t  _Smoothing;                                                    // Moving average shift             //
+      bool     _Started     = false;                                          // Moving average has a value       //
+  }; // of INA226_Filter definition                                           //                                  //
+  /*****************************************************************************************************************
+  ** Declare the INA226_Adaptive class, which holds the settings and state of the adaptive averaging controller   **
+  ** for one device. The controller works with levels from 0 to 7, where a level sets both the averaging index    **
+  ** and the bus and shunt conversion time indexes to that value. Level 0 is 1 average of 140us conversions and   **
+  ** level 7 is 1024 averages of 8.244ms conversions. When the current register of a new sample differs from the  **
+  ** previous one by fastDelta or more LSBs the controller jumps straight to minLevel. Once stableSamples samples **
+  ** in a row have changed by less than stableDelta it goes one level slower, up to maxLevel. The gap between the **
+  ** two thresholds and the sample count give the hysteresis.                                                     **
+  *****************************************************************************************************************/
+  class INA226_Adaptive {                                                     // Class definition                 //
+    public:                                                                   // Publicly visible methods         //
+      INA226_Adaptive(const uint16_t fastDelta=64,                            // Class constructor                //
+                      const uint16_t stableDelta=8,                           //                                  //
+                      const uint8_t  stableSamples=8,                         //                                  //
+                      const uint8_t  minLevel=0,                              //                                  //
+                      const uint8_t  maxLevel=7);                             //                                  //
+      uint8_t  level();                                                       // Level currently in use           //
+    private:                                                                  // Private variables and methods    //
+      friend class INA226_Class;                                              // adapt() runs the controller      //
+      uint16_t _FastDelta;                                                    // Change that selects minLevel     //
+      uint16_t _StableDelta;                                                  // Change that counts as stable     //
+      uint8_t  _StableSamples;                                                // Stable samples before slowing    //
+      uint8_t  _MinLevel;                                                     // Fastest level used               //
+      uint8_t  _MaxLevel;                                                     // Slowest level used               //
+      uint8_t  _Level;                                                        // Level currently in use           //
+      uint8_t  _StableCount = 0;                                              // Stable samples seen so far       //
+      int16_t  _LastCurrent = 0;                                              // Current register of last sample  //
+  }; // of INA226_Adaptive definition                                         //                                  //
+  /*****************************************************************************************************************
+  ** Declare the INA226_Config class, which collects changes to the fields of the configuration register so that  **
+  ** configure() can apply all of them with a single register write per device. Each call replaces one field and  **
+  ** returns the object, so the changes can be chained, for example INA226.configure(INA226_Config().averaging(16 **
+  ** ).busConversion(7).shuntConversion(7).mode(INA_MODE_CONTINUOUS_BOTH)). Fields which aren't set keep the      **
+  ** value each device already has.                                                                               **
+  *****************************************************************************************************************/
+  class INA226_Config {                                                       // Class definition                 //
+    public:                                                                   // Publicly visible methods         //
+      INA226_Config &averaging(const uint16_t averages) {                     // Set the number of averages taken //
+        return field(INA_CONFIG_AVG_MASK,                                     //                                  //
+                     (uint16_t)inaAveragingIndex(averages)<<9);               //                                  //
+      } // of method averaging()                                              //                                  //
+      INA226_Config &busConversion(const uint8_t convTime) {                  // Set timing for Bus conversions   //
+        return field(INA_CONFIG_BUS_TIME_MASK,                                //                                  //
+                     (uint16_t)(convTime>7 ? 7 : convTime)<<6);               //                                  //
+      } // of method busConversion()                                          //                                  //
+      INA226_Config &shuntConversion(const uint8_t convTime) {                // Set timing for Shunt conversions //
+        return field(INA_CONFIG_SHUNT_TIME_MASK,                              //                                  //
+                     (uint16_t)(convTime>7 ? 7 : convTime)<<3);               //                                  //
+      } // of method shuntConversion()                                        //                                  //
+      INA226_Config &mode(const uint8_t mode) {                               // Set the monitoring mode          //
+        return field(INA_CONFIG_MODE_MASK,mode&INA_CONFIG_MODE_MASK);         //                                  //
+      } // of method mode()                                                   //                                  //
+      uint16_t apply(const uint16_t configRegister) const {                   // Register with the changes made   //
+        return (configRegister&~_Mask)|_Bits;                                 //                                  //
+      } // of method apply()                                                  //                                  //
+      bool     hasMode() const {                                              // True if the mode is changed      //
+        return (_Mask&INA_CONFIG_MODE_MASK)!=0;                               //                                  //
+      } // of method hasMode()                                                //                                  //
+    private:                                                                  // Private variables and methods    //
+      INA226_Config &field(const uint16_t mask,const uint16_t bits) {         // Replace one field                //
+        _Mask |= mask;                                                        //                                  //
+        _Bits  = (_Bits&~mask)|bits;                                          //                                  //
+        return *this;                                                         //                                  //
+      } // of method field()                                                  //                                  //
+      uint16_t _Mask = 0;                                                     // Bits which are changed           //
+      uint16_t _Bits = 0;                                                     // and their new values             //
+  }; // of INA226_Config definition                                           //                                  //
+  /*****************************************************************************************************************
+  ** Declare the transport classes, which carry the register reads and writes of INA226_Class. The default is an  **
+  ** INA226_WireTransport on the global Wire object, another TwoWire instance such as a second I2C bus can be     **
+  ** used with setWire(). INA226_Transport is the interface: write() and read() work like the Wire                **
+  ** endTransmission() and requestFrom()/read() calls and are used for all the normal blocking calls. An          **
+  ** asynchronous backend for interrupt- or DMA-driven I2C also overrides startRead(), which starts reading 2     **
+  ** bytes from a register and returns INA_TRANSFER_PENDING at once, and calls complete() with the Wire status    **
+  ** when the transfer has finished, usually from its interrupt handler. The default startRead() does the read    **
+  ** there and then, so every transport also works with readRawAsync().                                           **
+  *****************************************************************************************************************/
+  class INA226_Class;                                                         // Forward declaration              //
+  typedef void (*INA226_AsyncCallback)(INA226_Sample samples[],               // Called when readRawAsync() is    //
+                                       const uint8_t count,                   // done, with samples read and the  //
+                                       const uint8_t status);                 // Wire status                      //
+  class INA226_Transport {                                                    // Class definition                 //
+    public:                                                                   // Publicly visible methods         //
+      virtual void    begin();                                                // Start the bus                    //
+      virtual bool    setClock(const uint32_t clockHz);                       // Set bus clock, false if it can't //
+      virtual uint8_t write(const uint8_t deviceAddress,const uint8_t data[], // Write bytes, return Wire status  //
+                            const uint8_t length)=0;                          //                                  //
+      virtual uint8_t read(const uint8_t deviceAddress,uint8_t data[],        // Read bytes, return number read   //
+                           const uint8_t length)=0;                           //                                  //
+      virtual uint8_t startRead(const uint8_t deviceAddress,                  // Start a 2 byte register read     //
+                                const uint8_t addr,uint8_t data[]);           //                                  //
+    protected:                                                                // Only used by the backends        //
+      void            complete(const uint8_t status);                         // startRead() transfer has finished//
+    private:                                                                  // Private variables and methods    //
+      friend class INA226_Class;                                              // setTransport() sets the owner    //
+      INA226_Class   *_Owner = NULL;                                          // Instance using the transport     //
+  }; // of INA226_Transport definition                                        //                                  //
+  class INA226_WireTransport : public INA226_Transport {                      // Class definition                 //
+    public:                                                                   // Publicly visible methods         //
+      INA226_WireTransport(TwoWire &wire=Wire);                               // Class constructor                //
+      void    begin();                                                        // Start the bus                    //
+      uint8_t write(const uint8_t deviceAddress,const uint8_t data[],         // Write bytes, return Wire status  //
+                    const uint8_t length);                                    //                                  //
+      uint8_t read(const uint8_t deviceAddress,uint8_t data[],                // Read bytes, return number read   //
+                   const uint8_t length);                                     //                                  //
+      bool    setClock(const uint32_t clockHz);                               // Set bus clock, HS mode above 1MHz//
+      uint8_t startRead(const uint8_t deviceAddress,                          // Register read with repeated start//
+                        const uint8_t addr,uint8_t data[]);                   //                                  //
+    private:                                                                  // Private variables and methods    //
+      void     enterHighSpeed();                                              // Send the HS mode master code     //
+      TwoWire *_Wire;                                                         // Bus used by the transport        //
+      uint32_t _Clock     = 0;                                                // Clock set, 0 for platform default//
+      bool     _HighSpeed = false;                                            // Enter HS mode on each transfer   //
+  }; // of INA226_WireTransport definition                                    //                                  //
+  /*****************************************************************************************************************
   ** Declare class header                                                                                         **
   *****************************************************************************************************************/
   class INA226_Class {                                                        // Class definition                 //
@@ -103,32 +653,354 @@
       uint8_t  begin(const uint8_t  maxBusAmps,                               // Class initializer                //
                      const uint32_t microOhmR,                                //                                  //
                      const uint8_t  deviceNumber = UINT8_MAX );               //                                  //
+      uint8_t  begin(const uint8_t  maxBusAmps,                               // Class initializer using a list   //
+                     const uint32_t microOhmR,                                // of known device addresses        //
+                     const uint8_t  addresses[],                              //                                  //
+                     const uint8_t  addressCount,                             //                                  //
+                     const bool     resetDevices,                             //                                  //
+                     const uint8_t  deviceNumber = UINT8_MAX );               //                                  //
+      uint8_t  begin(const uint8_t  maxBusAmps,                               // Class initializer using a bitmask//
+                     const uint32_t microOhmR,                                // of known device addresses        //
+                     const uint16_t addressMask,                              //                                  //
+                     const bool     resetDevices,                             //                                  //
+                     const uint8_t  deviceNumber = UINT8_MAX );               //                                  //
       uint16_t getBusMilliVolts(const bool waitSwitch=false,                  // Retrieve Bus voltage in mV       //
                                 const uint8_t deviceNumber=0);                //                                  //
       int16_t  getShuntMicroVolts(const bool waitSwitch=false,                // Retrieve Shunt voltage in uV     //
                                   const uint8_t deviceNumber=0);              //                                  //
       int32_t  getBusMicroAmps(const uint8_t deviceNumber=0);                 // Retrieve micro-amps              //
       int32_t  getBusMicroWatts(const uint8_t deviceNumber=0);                // Retrieve micro-watts             //
+      bool     readAll(const uint8_t deviceNumber,INA226_Reading &reading,    // Retrieve all measurements at once//
+                       const bool waitSwitch=false);                          //                                  //
+      void     convertSample(const INA226_Sample &sample,                     // Convert raw sample to units      //
+                             INA226_Reading &reading);                        //                                  //
+      void     convertSamples(const INA226_Sample samples[],                  // Convert a batch of raw samples   //
+                              INA226_Reading readings[],const uint8_t count); //                                  //
+      uint16_t getBusRaw(const uint8_t deviceNumber=0);                       // Raw bus voltage register         //
+      int16_t  getShuntRaw(const uint8_t deviceNumber=0);                     // Raw shunt voltage register       //
+      int16_t  getCurrentRaw(const uint8_t deviceNumber=0);                   // Raw current register             //
+      uint16_t getPowerRaw(const uint8_t deviceNumber=0);                     // Raw power register               //
+      bool     readRaw(const uint8_t deviceNumber,INA226_Sample &sample,      // Retrieve all raw values at once  //
+                       const bool waitSwitch=false);                          //                                  //
+      uint8_t  readRawAll(INA226_Sample samples[],                            // Raw registers of several devices //
+                          const uint16_t deviceMask=INA_ALL_DEVICES);         //                                  //
       void     reset(const uint8_t deviceNumber=0);                           // Reset the device                 //
       void     setMode(const uint8_t mode,const uint8_t devNumber=UINT8_MAX); // Set the monitoring mode          //
-      uint8_t  getMode(const uint8_t devNumber=UINT8_MAX);                    // Get the monitoring mode          //
+      uint8_t  getMode(const uint8_t devNumber=0);                            // Get the monitoring mode          //
       void     setAveraging(const uint16_t averages,                          // Set the number of averages taken //
                             const uint8_t deviceNumber=UINT8_MAX);            //                                  //
       void     setBusConversion(uint8_t convTime,                             // Set timing for Bus conversions   //
                                 const uint8_t deviceNumber=UINT8_MAX);        //                                  //
       void     setShuntConversion(uint8_t convTime,                           // Set timing for Shunt conversions //
                                   const uint8_t deviceNumber=UINT8_MAX);      //                                  //
+      uint16_t configure(const INA226_Config &config,                         // Apply configuration changes with //
+                         const uint16_t deviceMask=INA_ALL_DEVICES);          // one write per changed device     //
+      uint16_t getAveraging(const uint8_t deviceNumber=0);                    // Get the number of averages taken //
+      uint8_t  getBusConversion(const uint8_t deviceNumber=0);                // Get timing for Bus conversions   //
+      uint8_t  getShuntConversion(const uint8_t deviceNumber=0);              // Get timing for Shunt conversions //
       void     waitForConversion(const uint8_t deviceNumber=UINT8_MAX);       // wait for conversion to complete  //
+      uint16_t waitForConversion(const uint32_t timeoutMicros,                // Wait with timeout, return bitmask//
+                                 const uint16_t deviceMask);                  // of devices that are ready        //
+      uint32_t getConversionMicros(const uint8_t deviceNumber=0);             // Time taken in last timed wait    //
+      uint32_t getConversionPeriod(const uint8_t deviceNumber=0);             // Microseconds for one conversion  //
+      uint32_t nextReadyMicros(const uint8_t deviceNumber=UINT8_MAX);         // When next results are expected   //
+      uint8_t  serviceSchedule(INA226_SampleBuffer &buffer,                   // Read devices whose data is due   //
+                               const uint16_t deviceMask=INA_ALL_DEVICES);    //                                  //
+      uint16_t triggerAll(const uint16_t deviceMask=INA_ALL_DEVICES);         // Start conversions on all devices //
+      uint16_t collectAll(INA226_SampleBuffer &buffer,                        // Wait once and read all devices   //
+                          const uint32_t timeoutMicros=INA_AUTO_TIMEOUT,      //                                  //
+                          const uint16_t deviceMask=INA_ALL_DEVICES);         //                                  //
+      uint16_t sampleLowPower(INA226_SampleBuffer &buffer,                    // Trigger, sleep until ALERT, read //
+                              const uint8_t alertPin=UINT8_MAX,               // and power down again             //
+                              const uint16_t deviceMask=INA_ALL_DEVICES);     //                                  //
       void     setAlertPinOnConversion(const bool alertState,                 // Enable pin change on conversion  //
                                        const uint8_t deviceNumber=UINT8_MAX); //                                  //
+      void     setAlertLimit(const uint8_t alertType,const int32_t limit,     // Set limit alert in units         //
+                             const uint8_t deviceNumber=UINT8_MAX);           //                                  //
+      uint16_t getAlertLimit(const uint8_t deviceNumber=0);                   // Read the alert limit register    //
+      bool     getAlertFlag(const uint8_t deviceNumber=0);                    // True if the limit was exceeded   //
+      bool     saveConfig();                                                  // Store device table in EEPROM     //
+      uint8_t  loadConfig();                                                  // Restore device table from EEPROM //
+      bool     calibrateCurrent(const int32_t referenceMicroAmps,             // Measure a reference load and     //
+                                const uint8_t deviceNumber=0,                 // store the gain or offset         //
+                                const uint8_t samples=16);                    // correction                       //
+      void     setCorrection(const uint16_t gain,const int16_t offset,        // Set the correction directly      //
+                             const uint8_t deviceNumber=UINT8_MAX);           //                                  //
+      void     getCorrection(const uint8_t deviceNumber,uint16_t &gain,       // Get the correction in use        //
+                             int16_t &offset);                                //                                  //
+      void     setCorrectionInRegister(const bool inRegister,                 // Correct the gain in the          //
+                                       const uint8_t deviceNumber=UINT8_MAX); // calibration register             //
+      void     setI2CDelay(const uint8_t microSeconds);                       // Set delay before reading a value //
+      void     setFastPoll(const bool fastPoll);                              // Skip repeated pointer writes     //
+      void     setWire(TwoWire &wire);                                        // Use another I2C bus              //
+      void     setTransport(INA226_Transport &transport);                     // Use another transport            //
+      bool     setBusClock(const uint32_t clockHz);                           // Select the I2C bus clock         //
+      bool     readRawAsync(INA226_Sample samples[],                          // Read devices in the background   //
+                            INA226_AsyncCallback callback,                    //                                  //
+                            const uint16_t deviceMask=INA_ALL_DEVICES);       //                                  //
+      bool     asyncBusy();                                                   // True while readRawAsync() runs   //
+      bool     startSampling(INA226_SampleBuffer &buffer,                     // Start interrupt-driven sampling  //
+                             const uint8_t alertPin=UINT8_MAX,                //                                  //
+                             const uint8_t deviceNumber=UINT8_MAX);           //                                  //
+      bool     startAlertCapture(INA226_SampleBuffer &buffer,                 // Capture samples only when the    //
+                                 const uint8_t alertPin=UINT8_MAX,            // limit alert fires                //
+                                 const uint8_t deviceNumber=UINT8_MAX);       //                                  //
+      void     stopSampling();                                                // Stop interrupt-driven sampling   //
+      void     alertTriggered();                                              // Call from ALERT pin ISR          //
+      uint8_t  service();                                                     // Read devices flagged by the ISR  //
+      void     setStatistics(INA226_Statistics statistics[],                  // Keep statistics for devices 0 to //
+                             const uint8_t count);                            // count-1                          //
+      void     setAdaptive(INA226_Adaptive adaptive[],                        // Adapt averaging of devices 0 to  //
+                           const uint8_t count);                              // count-1                          //
+      void     setFilter(INA226_Filter filters[],const uint8_t count);        // Filter devices 0 to count-1      //
+      bool     getStatistics(const uint8_t deviceNumber,                      // Retrieve the statistics          //
+                             INA226_Summary &summary,                         //                                  //
+                             const bool clearWindow=false);                   //                                  //
+    #ifndef INA_NO_ENERGY                                                     // Unless accumulators compiled out //
+      int64_t  getChargeMicroCoulombs(const uint8_t deviceNumber=0);          // Charge since last resetEnergy()  //
+      int64_t  getEnergyMicroJoules(const uint8_t deviceNumber=0);            // Energy since last resetEnergy()  //
+      int64_t  getMicroAmpHours(const uint8_t deviceNumber=0);                // Charge in uAh                    //
+      int64_t  getMicroWattHours(const uint8_t deviceNumber=0);               // Energy in uWh                    //
+      void     resetEnergy(const uint8_t deviceNumber=UINT8_MAX);             // Zero the accumulators            //
+    #endif                                                                    //                                  //
+    #if INA_LOG_LEVEL>INA_LOG_NONE                                            // Only if logging is compiled in   //
+      void     setLogCallback(INA226_LogCallback callback);                   // Send log events to a callback    //
+      void     setLogBuffer(INA226_LogEntry entries[],                        // or store them in a ring buffer   //
+                            const uint8_t capacity);                          //                                  //
+      bool     readLog(INA226_LogEntry &entry);                               // Oldest stored event, if any      //
+      static void formatLog(const INA226_LogEntry &entry,Print &output);      // Print an event as text           //
+    #endif                                                                    //                                  //
+    #ifdef INA_INSTRUMENTATION                                                // Only if instrumentation is on    //
+      void     getCounters(const uint8_t deviceNumber,                        // Snapshot of the counters         //
+                           INA226_Counters &counters);                        //                                  //
+      void     resetCounters();                                               // Zero the counters of all devices //
+    #endif                                                                    //                                  //
     private:                                                                  // Private variables and methods    //
+      void     startBus();                                                    // Start the transport and its clock//
+      bool     probeDevice(const uint8_t deviceAddress,                       // Add device at address to table   //
+                           const bool resetDevice);                           //                                  //
+      void     applyCorrection(inaDet &ina);                                  // Set multipliers and calibration  //
+      int32_t  microAmps(const inaDet &ina,const int16_t currentRaw);         // Current with offset correction   //
+      uint32_t correctedLSB(const inaDet &ina);                               // Current LSB with gain correction //
+      uint16_t correctedCalibration(const inaDet &ina);                       // Calibration with gain correction //
+      uint8_t  calibrate(const uint8_t maxBusAmps,const uint32_t microOhmR,   // Compute and write calibration    //
+                         const uint8_t deviceNumber);                         //                                  //
+      inaDet&  device(const uint8_t deviceNumber);                            // Device table entry for a number  //
       uint8_t  readByte(const uint8_t addr, const uint8_t deviceAddress);     // Read a byte from an I2C address  //
       int16_t  readWord(const uint8_t addr, const uint8_t deviceAddress);     // Read a word from an I2C address  //
       void     writeByte(const uint8_t addr, const uint8_t data,              // Write a byte to an I2C address   //
                          const uint8_t deviceAddress);                        //                                  //
       void     writeWord(const uint8_t addr, const uint16_t data,             // Write two bytes to an I2C address//
                          const uint8_t deviceAddress);                        //                                  //
+      uint16_t waitForReset(const uint8_t deviceAddress);                     // Wait until device reset is done  //
+      void     setPointer(const uint8_t addr, const uint8_t deviceAddress);   // Set the device register pointer  //
+      void     writeConfiguration(inaDet &ina);                               // Write cached configuration       //
+      uint32_t conversionPeriod(const uint16_t configRegister);               // Microseconds for one conversion  //
+      bool     readSample(const uint8_t deviceNumber,INA226_Sample &sample,   // Read all 4 raw registers         //
+                          const bool waitSwitch);                             //                                  //
+      bool     store(INA226_SampleBuffer &buffer,INA226_Sample &sample,       // Handle a new sample from engines //
+                     const uint32_t timeMicros);                              //                                  //
+      void     adapt(const INA226_Sample &sample);                            // Run the averaging controller     //
+      void     setLevel(inaDet &ina,const uint8_t level);                     // Write an averaging level         //
+      void     accumulate(const INA226_Sample &sample,                        // Add sample to the accumulators   //
+                          const uint32_t timeMicros);                         //                                  //
+      void     readRegisters(inaDet &ina,INA226_Sample &sample);              // Read registers, flag unchanged   //
+      friend class INA226_Transport;                                          // complete() calls asyncComplete() //
+      void     asyncComplete(const uint8_t status);                           // Background read has finished     //
+      void     asyncNext(uint8_t status);                                     // Start the next background read   //
+      void     asyncStore();                                                  // Store a background read value    //
       uint8_t  _TransmissionStatus = 0;                                       // Return code for I2C transmission //
       uint8_t  _DeviceCount        = 0;                                       // Number of INA226s detected       //
+      uint8_t  _I2CDelay           = I2C_DELAY;                               // Microseconds before each read    //
+      inaDet   _Devices[INA_MAX_DEVICES];                                     // RAM working copy of device data  //
+      bool     _FastPoll           = false;                                   // Use register pointer cache       //
+      uint8_t  _RegisterPointer[INA_POINTER_INDEX_MASK+1];                    // Last pointer for each address    //
+      uint32_t _ConversionMicros[INA_MAX_DEVICES];                            // Wait time of last timed wait     //
+      uint32_t _ReadyMicros[INA_MAX_DEVICES];                                 // When next results are expected   //
+      uint32_t _TriggerMicros      = 0;                                       // Time of last triggerAll() call   //
+      uint16_t _TriggeredDevices   = 0;                                       // Devices not yet collected        //
+      void     sleepUntilAlert(const uint32_t timeoutMicros);                 // Sleep until ALERT or the timeout //
+      static void alertISR();                                                 // ISR attached by startSampling()  //
+      static INA226_Class *_SamplingInstance;                                 // Instance using attached ISR      //
+      INA226_SampleBuffer *_SampleBuffer = NULL;                              // Buffer to store samples in       //
+      uint16_t _SamplingDevices    = 0;                                       // Bitmask of devices sampled       //
+      uint8_t  _AlertPin           = UINT8_MAX;                               // Pin the ALERT line is wired to   //
+      volatile bool _AlertFlag     = false;                                   // Set by the ISR on pin change     //
+      INA226_Statistics *_Statistics = NULL;                                  // Statistics for the first devices //
+      uint8_t  _StatisticsCount    = 0;                                       // Number of statistics blocks      //
+      INA226_Adaptive *_Adaptive   = NULL;                                    // Controllers for the first devices//
+      uint8_t  _AdaptiveCount      = 0;                                       // Number of controllers            //
+      INA226_Filter *_Filters      = NULL;                                    // Filters for the first devices    //
+      uint8_t  _FilterCount        = 0;                                       // Number of filters                //
+      bool     _AlertCapture       = false;                                   // Sampling on limit alerts only    //
+      INA226_WireTransport _WireTransport;                                    // Default transport on Wire        //
+      INA226_Transport *_Transport = &_WireTransport;                         // Transport used for all transfers //
+      uint32_t _BusClock           = 0;                                       // setBusClock() value, 0 if unset  //
+      INA226_Sample *_AsyncSamples = NULL;                                    // readRawAsync() samples array     //
+      INA226_AsyncCallback _AsyncCallback = NULL;                             // and callback                     //
+      uint16_t _AsyncMask          = 0;                                       // Devices to read                  //
+      uint8_t  _AsyncDevice        = 0;                                       // Device being read                //
+      uint8_t  _AsyncRegister      = 0;                                       // Register being read, 0 if none   //
+      uint8_t  _AsyncCount         = 0;                                       // Samples completed                //
+      uint8_t  _AsyncData[2];                                                 // Bytes of the register being read //
+      volatile bool _AsyncBusy     = false;                                   // Set while readRawAsync() runs    //
+    #ifndef INA_NO_ENERGY                                                     // Unless accumulators compiled out //
+      int64_t  _Charge[INA_MAX_DEVICES] = {};                                 // Sum of uA*us since reset         //
+      int64_t  _Energy[INA_MAX_DEVICES] = {};                                 // Sum of uW*us since reset         //
+      uint32_t _EnergyMicros[INA_MAX_DEVICES];                                // Time of last accumulated sample  //
+      uint16_t _EnergyStarted      = 0;                                       // Devices with a sample time       //
+    #endif                                                                    //                                  //
+    #if INA_LOG_LEVEL>INA_LOG_NONE                                            // Only if logging is compiled in   //
+      void     logEvent(const uint8_t level,const uint8_t event,              // Store or send a log event        //
+                        const uint8_t address,const int32_t value);           //                                  //
+      INA226_LogCallback _LogCallback = NULL;                                 // Callback sink                    //
+      INA226_LogEntry *_LogEntries = NULL;                                    // Buffer sink                      //
+      uint8_t  _LogMask            = 0;                                       // Capacity-1, capacity a power of 2//
+      volatile uint8_t _LogHead    = 0;                                       // Next entry to write              //
+      volatile uint8_t _LogTail    = 0;                                       // Next entry to read               //
+    #endif                                                                    //                                  //
+    #ifdef INA_INSTRUMENTATION                                                // Only if instrumentation is on    //
+      void     count(const uint8_t deviceAddress,const uint8_t bytes,         // Count an I2C transaction         //
+                     const bool failed);                                      //                                  //
+      INA226_Counters _Counters[INA_POINTER_INDEX_MASK+1] = {};               // Counters for each address        //
+    #endif                                                                    //                                  //
   }; // of INA226_Class definition                                            //                                  //
+  /*****************************************************************************************************************
+  ** Declare the INA226_Multi class, which manages several INA226_Class instances that are each on their own I2C  **
+  ** bus, set up with setWire() or setTransport(), so that more devices can be sampled than one bus has bandwidth **
+  ** for. The devices of all the buses get global device numbers, those of the first bus come first, then those   **
+  ** of the second bus and so on, and locate() maps a global number back to the bus and its device number there.  **
+  ** readRawAsync() starts the reads on all the buses at once, so with asynchronous transports the buses run      **
+  ** concurrently and the callback is called once when all of them are done. The samples passed to the callback   **
+  ** and those from readRawAll() carry global device numbers and are converted with the convertSample() of this   **
+  ** class.                                                                                                       **
+  *****************************************************************************************************************/
+  class INA226_Multi {                                                        // Class definition                 //
+    public:                                                                   // Publicly visible methods         //
+      INA226_Multi(INA226_Class buses[],const uint8_t busCount);              // Class constructor                //
+      uint8_t  begin(const uint8_t maxBusAmps,const uint32_t microOhmR);      // Start all buses, return devices  //
+      uint8_t  deviceCount();                                                 // Devices on all buses             //
+      INA226_Class *locate(const uint8_t deviceNumber,                        // Bus instance and its device      //
+                           uint8_t &busDevice);                               // number for a global number       //
+      void     convertSample(const INA226_Sample &sample,                     // Convert raw sample to units      //
+                             INA226_Reading &reading);                        //                                  //
+      uint8_t  triggerAll();                                                  // Start conversions on all buses   //
+      uint8_t  readRawAll(INA226_Sample samples[]);                           // Raw registers of all devices     //
+      bool     readRawAsync(INA226_Sample samples[],                          // Read all buses concurrently      //
+                            INA226_AsyncCallback callback);                   //                                  //
+      bool     asyncBusy();                                                   // True while readRawAsync() runs   //
+    private:                                                                  // Private variables and methods    //
+      static void asyncDone(INA226_Sample samples[],const uint8_t count,      // Completion of one bus            //
+                            const uint8_t status);                            //                                  //
+      static INA226_Multi *_AsyncInstance;                                    // Instance with reads running      //
+      INA226_Class *_Buses;                                                   // Instances, one per bus           //
+      uint8_t  _BusCount;                                                     // Number of buses                  //
+      uint8_t  _FirstDevice[INA_MAX_BUSES+1] = {};                            // Global number of first device    //
+      INA226_Sample *_AsyncSamples = NULL;                                    // readRawAsync() samples array     //
+      INA226_AsyncCallback _AsyncCallback = NULL;                             // and callback                     //
+      uint8_t  _AsyncCount[INA_MAX_BUSES];                                    // Samples read on each bus         //
+      volatile uint8_t _AsyncPending = 0;                                     // Buses still reading              //
+      volatile uint8_t _AsyncStatus  = 0;                                     // First failure status, 0 if none  //
+  }; // of INA226_Multi definition                                            //                                  //
+  /*****************************************************************************************************************
+  ** Declare the INA226_Fixed template for boards with a fixed hardware layout. The address, shunt resistance and **
+  ** maximum current are template parameters, so the LSBs, calibration and multipliers are all compile time       **
+  ** constants from INA226_Scale and the only RAM used is the cached configuration register. There is no device   **
+  ** table, no device number lookup and nothing stored in EEPROM, and since all of the methods are inline the     **
+  ** compiler can reduce each read to the Wire calls for that one address. One instance is declared for each      **
+  ** device. Unlike INA226_Class the reads don't start a new conversion in triggered mode, that is done with an   **
+  ** explicit call to trigger().                                                                                  **
+  *****************************************************************************************************************/
+  template <uint8_t Address,uint32_t MicroOhmR,uint8_t MaxBusAmps>            // Class definition                 //
+  class INA226_Fixed {                                                        //                                  //
+    typedef INA226_Scale<MaxBusAmps,MicroOhmR> Scale;                         // Compile time conversion values   //
+    static_assert(Address>=0x40 && Address<=0x4F,                             // INA226 addresses are 0x40-0x4F   //
+                  "Address must be from 0x40 to 0x4F");                       //                                  //
+    public:                                                                   // Publicly visible methods         //
+      bool begin(const bool resetDevice=true) {                               // Class initializer                //
+        Wire.begin();                                                         // Start the I2C wire subsystem     //
+        if (resetDevice) {                                                    // If the device is to be reset,    //
+          writeWord(INA_CONFIGURATION_REGISTER,INA_RESET_DEVICE);             // force the INA to reset and wait  //
+          uint32_t startMillis = millis();                                    // until it is done                 //
+          while ((readWord(INA_CONFIGURATION_REGISTER)&INA_RESET_DEVICE) &&   //                                  //
+                 millis()-startMillis<INA_RESET_TIMEOUT);                     //                                  //
+          _Configuration = INA_DEFAULT_CONFIGURATION;                         // Register shadow after the reset  //
+        } else {                                                              // otherwise use the configuration  //
+          _Configuration = readWord(INA_CONFIGURATION_REGISTER);              // the device already has           //
+        } // of if-then-else reset device                                     //                                  //
+        return writeWord(INA_CALIBRATION_REGISTER,Scale::calibration);        // Write the calibration value      //
+      } // of method begin()                                                  //                                  //
+      uint16_t getBusMilliVolts() {                                           // Retrieve Bus voltage in mV       //
+        return inaBusMilliVolts(readWord(INA_BUS_VOLTAGE_REGISTER));          //                                  //
+      } // of method getBusMilliVolts()                                       //                                  //
+      int16_t  getShuntMicroVolts() {                                         // Retrieve Shunt voltage in uV     //
+        return inaShuntMicroVolts(readWord(INA_SHUNT_VOLTAGE_REGISTER));      //                                  //
+      } // of method getShuntMicroVolts()                                     //                                  //
+      int32_t  getBusMicroAmps() {                                            // Retrieve micro-amps              //
+        return Scale::microAmps(readWord(INA_CURRENT_REGISTER));              //                                  //
+      } // of method getBusMicroAmps()                                        //                                  //
+      int32_t  getBusMicroWatts() {                                           // Retrieve micro-watts             //
+        return Scale::microWatts(readWord(INA_POWER_REGISTER));               //                                  //
+      } // of method getBusMicroWatts()                                       //                                  //
+      bool     readAll(INA226_Reading &reading) {                             // Retrieve all measurements at once//
+        bool newData = conversionReady();                                     // Check and reset the ready flag   //
+        reading.deviceNumber    = 0;                                          //                                  //
+        reading.busMilliVolts   = getBusMilliVolts();                         //                                  //
+        reading.shuntMicroVolts = getShuntMicroVolts();                       //                                  //
+        reading.busMicroAmps    = getBusMicroAmps();                          //                                  //
+        reading.busMicroWatts   = getBusMicroWatts();                         //                                  //
+        return newData;                                                       // Return true if the data is new   //
+      } // of method readAll()                                                //                                  //
+      bool     conversionReady() {                                            // Check and reset the ready flag   //
+        return readWord(INA_MASK_ENABLE_REGISTER)&INA_CONVERSION_READY_MASK;  //                                  //
+      } // of method conversionReady()                                        //                                  //
+      void     trigger() {                                                    // Start a triggered conversion     //
+        writeWord(INA_CONFIGURATION_REGISTER,_Configuration);                 //                                  //
+      } // of method trigger()                                                //                                  //
+      void     setMode(const uint8_t mode) {                                  // Set the monitoring mode          //
+        _Configuration = (_Configuration&~INA_CONFIG_MODE_MASK)|              //                                  //
+                         (mode&INA_CONFIG_MODE_MASK);                         //                                  //
+        trigger();                                                            //                                  //
+      } // of method setMode()                                                //                                  //
+      void     setAveraging(const uint16_t averages) {                        // Set the number of averages taken //
+        _Configuration = (_Configuration&~INA_CONFIG_AVG_MASK)|               //                                  //
+                         (uint16_t)inaAveragingIndex(averages)<<9;            //                                  //
+        trigger();                                                            //                                  //
+      } // of method setAveraging()                                           //                                  //
+      void     setBusConversion(const uint8_t convTime) {                     // Set timing for Bus conversions   //
+        _Configuration = (_Configuration&~INA_CONFIG_BUS_TIME_MASK)|          //                                  //
+                         (uint16_t)(convTime>7 ? 7 : convTime)<<6;            //                                  //
+        trigger();                                                            //                                  //
+      } // of method setBusConversion()                                       //                                  //
+      void     setShuntConversion(const uint8_t convTime) {                   // Set timing for Shunt conversions //
+        _Configuration = (_Configuration&~INA_CONFIG_SHUNT_TIME_MASK)|        //                                  //
+                         (uint16_t)(convTime>7 ? 7 : convTime)<<3;            //                                  //
+        trigger();                                                            //                                  //
+      } // of method setShuntConversion()                                     //                                  //
+      void     configure(const INA226_Config &config) {                       // Apply configuration changes      //
+        _Configuration = config.apply(_Configuration);                        //                                  //
+        trigger();                                                            //                                  //
+      } // of method configure()                                              //                                  //
+    private:                                                                  // Private variables and methods    //
+      int16_t  readWord(const uint8_t addr) {                                 // Read a word from a register      //
+        Wire.beginTransmission(Address);                                      // Point to the register to read    //
+        Wire.write(addr);                                                     //                                  //
+        Wire.endTransmission();                                               //                                  //
+        #ifndef INA_NO_I2C_DELAY                                              // Unless delay is compiled out     //
+          delayMicroseconds(I2C_DELAY);                                       // delay before the read            //
+        #endif                                                                //                                  //
+        Wire.requestFrom(Address,(uint8_t)2);                                 // Request 2 consecutive bytes      //
+        int16_t returnData = Wire.read()<<8;                                  // Read the msb                     //
+        returnData |= Wire.read();                                            // and the lsb                      //
+        return returnData;                                                    //                                  //
+      } // of method readWord()                                               //                                  //
+      bool     writeWord(const uint8_t addr,const uint16_t data) {            // Write a word to a register       //
+        Wire.beginTransmission(Address);                                      // Address the I2C device           //
+        Wire.write(addr);                                                     // Send register address to write   //
+        Wire.write((uint8_t)(data>>8));                                       // Write the first byte             //
+        Wire.write((uint8_t)data);                                            // and then the second              //
+        return Wire.endTransmission()==0;                                     // Return true if it worked         //
+      } // of method writeWord()                                              //                                  //
+      uint16_t _Configuration = INA_DEFAULT_CONFIGURATION;                    // Shadow of configuration register //
+  }; // of INA226_Fixed definition                                            //                                  //
 #endif                                                                        //----------------------------------//